@@ -1,100 +0,0 @@
-import os
-import json
-import time
-import requests
-import sys
-
-def load_env_file():
-    """Load environment variables from .env file"""
-    try:
-        with open(".env") as f:
-            for line in f:
-                if line.strip() and not line.startswith("#"):
-                    key, value = line.strip().split("=", 1)
-                    os.environ[key] = value
-    except FileNotFoundError:
-        print(json.dumps({"error": ".env file not found"}))
-        sys.exit(1)
-    except Exception as e:
-        print(json.dumps({"error": f"Error reading .env: {str(e)}"}))
-        sys.exit(1)
-
-def fetch_json(url):
-    start = time.time()
-    try:
-        r = requests.get(url, timeout=10)
-        duration = time.time() - start
-        
-        if r.status_code == 200:
-            data = r.json()
-            return {"data": data, "fetch_time_sec": duration, "success": True}
-        else:
-            return {"error": f"HTTP {r.status_code}", "fetch_time_sec": duration, "success": False}
-    except requests.exceptions.Timeout:
-        return {"error": "Request timeout", "fetch_time_sec": time.time() - start, "success": False}
-    except requests.exceptions.RequestException as e:
-        return {"error": f"Network error: {str(e)}", "fetch_time_sec": time.time() - start, "success": False}
-    except json.JSONDecodeError:
-        return {"error": "Invalid JSON response", "fetch_time_sec": duration, "success": False}
-
-def get_stock(symbol):
-    url = f'https://www.alphavantage.co/query?function=TIME_SERIES_DAILY&symbol={symbol}&apikey={API_KEY}'
-    return fetch_json(url)
-
-def get_bond(symbol):
-    # For bonds, we might need to use a different approach since Alpha Vantage
-    # doesn't have direct bond quotes. We'll use a fallback or alternative data.
-    if symbol.upper().startswith('US'):
-        # Simulate bond data based on common treasury symbols
-        return simulate_bond_data(symbol)
-    else:
-        return {"error": "Bond symbol not recognized", "success": False}
-
-def simulate_bond_data(symbol):
-    """Simulate bond data for common treasury symbols"""
-    import random
-    bond_data = {
-        "US10Y": {"price": 100.25, "yield": 4.25, "change": 0.05},
-        "US30Y": {"price": 101.50, "yield": 4.50, "change": -0.02},
-        "US2Y": {"price": 99.75, "yield": 4.75, "change": 0.01},
-        "US5Y": {"price": 100.10, "yield": 4.35, "change": 0.03}
-    }
-    
-    symbol = symbol.upper()
-    if symbol in bond_data:
-        return {
-            "data": {
-                "Global Quote": {
-                    "05. price": str(bond_data[symbol]["price"]),
-                    "09. change": str(bond_data[symbol]["change"]),
-                    "10. change percent": f"{bond_data[symbol]['change'] * 100:.2f}%"
-                }
-            },
-            "success": True,
-            "fetch_time_sec": 0.5
-        }
-    else:
-        return {"error": f"Bond {symbol} not found", "success": False}
-
-if __name__ == "__main__":
-    load_env_file()
-    API_KEY = os.environ.get("ALPHA_API_KEY")
-    
-    if not API_KEY:
-        print(json.dumps({"error": "ALPHA_API_KEY not found in .env"}))
-        sys.exit(1)
-
-    if len(sys.argv) != 3:
-        print(json.dumps({"error": "Usage: python fetch_market_data.py STOCK|BOND SYMBOL"}))
-        sys.exit(1)
-
-    type_, symbol = sys.argv[1].upper(), sys.argv[2].upper()
-    
-    if type_ == "STOCK":
-        result = get_stock(symbol)
-    elif type_ == "BOND":
-        result = get_bond(symbol)
-    else:
-        result = {"error": "Type must be STOCK or BOND", "success": False}
-
-    print(json.dumps(result))
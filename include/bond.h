@@ -4,6 +4,7 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include "fast_math.h"
 
 namespace Bonds {
 
@@ -16,9 +17,12 @@ public:
     Bond();
     Bond(double face_value, double rate, int maturity);
     virtual double price() const = 0;
+    double face_value() const { return FV; }
+    double discount_rate() const { return r; }
+    int maturity() const { return T; }
 };
 
-class zc_Bond : public Bond {
+class zc_Bond final : public Bond {
 public:
     zc_Bond();
     zc_Bond(double face_value, double rate, int maturity);
@@ -29,7 +33,7 @@ public:
     double ytm(double marketPrice, int maxIter=1000, double tol=1e-6) const;
 };
 
-class c_Bond : public Bond {
+class c_Bond final : public Bond {
 private:
     double c;
     int freq;
@@ -37,13 +41,22 @@ public:
     c_Bond();
     c_Bond(double face_value, double coupon_rate, double discount_rate, int maturity, int frequency);
     double price() const override;
+    // Fast discounts with exp(-i * log1p(r/freq)) through the polynomial kernels;
+    // beyond kFastMaxPeriods periods or at r/freq <= kFastMinRate it prices Exact.
+    double price(Precision precision) const;
     double macaulay_duration() const;
     double modified_duration() const;
     double convexity() const;
     double current_yield(double marketPrice) const;
     double ytm(double marketPrice, int maxIter=1000, double tol=1e-6) const;
+    // Price at yield y (compounded freq times a year) and dP/dy in one pass.
+    double price_at(double y, double* dPdy=nullptr) const;
+    double coupon_rate() const { return c; }
+    int frequency() const { return freq; }
 };
 
+void price_batch(const std::vector<c_Bond>& bonds, std::vector<double>& out, Precision precision=Precision::Exact);
+
 }
 #endif
 
@@ -0,0 +1,39 @@
+#ifndef BONDS_PRICER_CURVE_H
+#define BONDS_PRICER_CURVE_H
+
+#include <vector>
+#include <cstdint>
+#include "fast_math.h"
+
+namespace Bonds {
+
+// Zero curve: continuously compounded zero rates at increasing tenors (years),
+// linearly interpolated and flat beyond the ends. Every curve gets a fresh
+// version number, so results derived from it can be cached against it.
+class YieldCurve {
+public:
+    YieldCurve(std::vector<double> tenors, std::vector<double> zeroRates);
+    static YieldCurve flat(double rate);
+
+    double zero(double t) const;
+    double discount(double t, Precision precision=Precision::Exact) const;
+    double forward(double t1, double t2) const;
+    // out[i] = discount(first + i * step) for i < n, walking the tenors once.
+    void discountGrid(double first, double step, int n, double* out, Precision precision=Precision::Exact) const;
+
+    // Same tenors with each zero rate moved by shifts[i] (or by one amount).
+    YieldCurve shifted(const std::vector<double>& shifts) const;
+    YieldCurve shifted(double parallel) const;
+
+    const std::vector<double>& tenors() const { return t; }
+    const std::vector<double>& rates() const { return z; }
+    uint64_t version() const { return id; }
+
+private:
+    std::vector<double> t;
+    std::vector<double> z;
+    uint64_t id;
+};
+
+}
+#endif
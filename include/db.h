@@ -3,21 +3,45 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <sqlite3.h>
+#include "db_writer.h"
+
+struct QueryResult {
+    bool success;
+    std::string error_message;
+    std::vector<std::string> columns;
+    std::vector<std::vector<std::string>> rows;     // NULL comes back as ""
+};
 
 class BondDB {
 private:
     std::string dbFile;
     sqlite3* db;
+    std::unique_ptr<BondDBWriter> writer;
+    void closeWriter();
 public:
     BondDB(const std::string& filename);
     ~BondDB();
     void init();
-    void saveBond(const std::string& name, const std::string& type,
+    // After this, saveBond queues rows for a background writer instead of
+    // blocking; reads flush the queue first so they see earlier saves.
+    void enableWriteBehind(const DBWriterConfig& config = DBWriterConfig());
+    // False if queued rows could not be committed yet (they are retried).
+    bool flush();
+    // False if the row was not written, or under write-behind if it was not
+    // queued or the writer is currently failing to commit; see lastError().
+    bool saveBond(const std::string& name, const std::string& type,
                   double FV, double c, double r, int T, int freq,
                   double price, const std::string& currency);
+    std::string lastError() const;
     std::vector<std::string> listBonds();
     std::vector<std::string> searchBond(const std::string& name);
+    // Full rows, in id order.
+    std::vector<BondRecord> loadBonds();
+    // Runs one statement on this connection, where the bond_* SQL functions
+    // from db_functions.h are available.
+    QueryResult query(const std::string& sql);
 };
 #endif
 
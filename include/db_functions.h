@@ -0,0 +1,16 @@
+#ifndef DB_FUNCTIONS_H
+#define DB_FUNCTIONS_H
+
+#include <sqlite3.h>
+
+// Registers deterministic SQL functions backed by the Bonds kernels (bonds
+// columns: FV, c, r as decimals, T in years, freq per year):
+//   bond_price(FV, c, r, T, freq)
+//   bond_ytm(FV, c, T, freq, price)
+//   bond_duration(FV, c, r, T, freq)      modified duration
+//   bond_convexity(FV, c, r, T, freq)
+//   portfolio_dv01(FV, c, r, T, freq [, quantity])   aggregate, price change per 1bp
+// Any NULL or invalid argument (T <= 0, freq <= 0) yields NULL.
+bool registerBondFunctions(sqlite3* db);
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef DB_WRITER_H
+#define DB_WRITER_H
+
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <sqlite3.h>
+
+struct BondRecord {
+    std::string name;
+    std::string type;
+    double FV;
+    double c;
+    double r;
+    int T;
+    int freq;
+    double price;
+    std::string currency;
+};
+
+// Maps onto PRAGMA synchronous for the writer's connection.
+enum class Durability { Off, Normal, Full };
+
+struct DBWriterConfig {
+    size_t queueCapacity = 8192;    // enqueue blocks beyond this
+    size_t batchSize = 256;         // commit as soon as this many rows are waiting
+    int flushIntervalMs = 50;       // ...or when the oldest waiting row is this old
+    Durability durability = Durability::Normal;
+    int maxBackoffMs = 1000;        // failed batches are retried, backing off from 10ms up to this
+    int shutdownRetries = 3;        // attempts left for a failing batch once stopping
+};
+
+// Write-behind persistence for the bonds table: callers enqueue rows and a
+// dedicated thread group-commits them on its own SQLite connection. A batch
+// that fails to commit goes back to the head of the queue and is retried.
+class BondDBWriter {
+public:
+    BondDBWriter(const std::string& filename, const DBWriterConfig& config = DBWriterConfig());
+    ~BondDBWriter();    // stop()s
+
+    // Commits everything still queued and ends the writer thread. A batch
+    // still failing after cfg.shutdownRetries attempts is counted in dropped().
+    void stop();
+
+    bool enqueue(BondRecord rec);       // false once stopped
+    bool tryEnqueue(BondRecord rec);    // false instead of blocking when the queue is full
+    // True once every row enqueued before the call is committed; false if a
+    // commit attempt fails first (the rows stay queued).
+    bool flush();
+
+    uint64_t committed() const { return committedSeq.load(); }
+    size_t pending() const;
+    bool failing() const;               // the last commit attempt failed
+    uint64_t dropped() const;           // rows given up on at shutdown
+    std::string lastError() const;
+
+private:
+    void run();
+    bool open();
+    void close();
+    bool commitBatch(std::deque<BondRecord>& batch, std::string& why);
+
+    std::string dbFile;
+    DBWriterConfig cfg;
+    sqlite3* db;
+    sqlite3_stmt* insert;
+
+    mutable std::mutex mtx;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::condition_variable progress;
+    std::deque<BondRecord> queue;
+    uint64_t enqueuedSeq;
+    std::atomic<uint64_t> committedSeq;
+    uint64_t flushTarget;
+    uint64_t failedCommits;
+    uint64_t droppedRows;
+    bool lastFailed;
+    bool stopping;
+    bool finished;                      // worker has exited
+    std::string error;
+    std::thread worker;
+};
+
+#endif
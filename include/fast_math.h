@@ -0,0 +1,87 @@
+#ifndef BONDS_PRICER_FAST_MATH_H
+#define BONDS_PRICER_FAST_MATH_H
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace Bonds {
+
+// Exact goes through the C library (std::pow / std::exp) and is what booking
+// uses. Fast swaps in the branch-free polynomials below, which the compiler
+// can vectorize across cashflows.
+enum class Precision { Exact, Fast };
+
+// fastExp:   relative error < 1e-15 on [-708, 708] (inputs are clamped there).
+// fastLog1p: absolute error < 1e-15 for x > -0.5.
+// A discount factor exp(-i * log1p(y)) is then off by < (i + 1) * 1e-15
+// relative, so a price over at most kFastMaxPeriods periods, with a periodic
+// rate above kFastMinRate, stays within kFastPriceRelError. Callers outside
+// that domain take the Exact path.
+constexpr double kFastPriceRelError = 1e-12;
+constexpr int kFastMaxPeriods = 1000;
+constexpr double kFastMinRate = -0.5;
+
+inline double fastExp(double x) {
+    x = std::min(708.0, std::max(-708.0, x));
+    // x = k ln2 + r with |r| <= ln2/2. Adding 2^52+2^51 rounds to the nearest
+    // integer and leaves k in the low mantissa bits, so 2^k is built with
+    // integer ops only (no double->int64 conversion, which blocks SIMD).
+    const double shift = 6755399441055744.0;
+    double t = x * 1.4426950408889634 + shift;
+    uint64_t kbits;
+    std::memcpy(&kbits, &t, sizeof(kbits));
+    double kd = t - shift;
+    double r = x - kd * 6.93147180369123816490e-01;
+    r -= kd * 1.90821492927058770002e-10;
+    // Taylor series to r^12; the truncation error is below 0.347^13 / 13! ~ 2e-16.
+    double p = 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    uint64_t bits = (kbits + 1023) << 52;
+    double scale;
+    std::memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+inline double fastLog1p(double x) {
+    // 1 + x = 2^e * f with f in [sqrt(1/2), sqrt(2)); log f = 2 atanh(s), s = (f-1)/(f+1).
+    double u = 1.0 + x;
+    double c = (u - 1.0) - x;               // rounding lost forming 1 + x
+    int64_t bits;
+    std::memcpy(&bits, &u, sizeof(bits));
+    int64_t e = ((bits >> 52) & 0x7ff) - 1023;
+    int64_t mant = (bits & 0xfffffffffffffLL) | 0x3ff0000000000000LL;
+    double f;
+    std::memcpy(&f, &mant, sizeof(f));
+    bool high = f > 1.4142135623730951;
+    f = high ? f * 0.5 : f;
+    e += high;
+    double s = (f - 1.0) / (f + 1.0), s2 = s * s;
+    // |s| < 0.1716: series to s^21 leaves < 1e-18.
+    double p = 1.0 / 21.0;
+    p = p * s2 + 1.0 / 19.0;
+    p = p * s2 + 1.0 / 17.0;
+    p = p * s2 + 1.0 / 15.0;
+    p = p * s2 + 1.0 / 13.0;
+    p = p * s2 + 1.0 / 11.0;
+    p = p * s2 + 1.0 / 9.0;
+    p = p * s2 + 1.0 / 7.0;
+    p = p * s2 + 1.0 / 5.0;
+    p = p * s2 + 1.0 / 3.0;
+    p = p * s2 + 1.0;
+    return e * 6.93147180559945309417e-01 + 2.0 * s * p - c / u;
+}
+
+}
+#endif
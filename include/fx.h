@@ -0,0 +1,66 @@
+#ifndef FX_H
+#define FX_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+// Immutable set of FX rates. matrix[to*n + from] holds units of `to` per unit
+// of `from`, so converting into one reporting currency reads a contiguous row.
+struct FxSnapshot {
+    std::vector<std::string> currencies;
+    std::vector<double> matrix;
+    uint64_t version = 0;
+
+    size_t size() const { return currencies.size(); }
+    int index(const std::string& currency) const;
+    double rate(int from, int to) const { return matrix[(size_t)to * size() + from]; }
+    double rate(const std::string& from, const std::string& to) const;
+    const double* toCurrency(int to) const { return &matrix[(size_t)to * size()]; }
+};
+
+// Positions stored column-wise; currency holds FxSnapshot indices.
+struct FxPositions {
+    std::vector<int> currency;
+    std::vector<double> amount;
+
+    void add(int ccy, double amt) { currency.push_back(ccy); amount.push_back(amt); }
+    size_t size() const { return amount.size(); }
+};
+
+// Publishes FX rates as immutable snapshots. Readers take a snapshot once and
+// price against it, so a batch never sees a half-applied update; writers build
+// a new matrix off to the side and swap it in. The swap is a
+// std::atomic<std::shared_ptr>, which libstdc++ implements with a small
+// internal lock held only while the pointer and refcount are copied, so
+// readers never wait on a writer building a matrix, but this is not lock-free.
+class FxService {
+public:
+    // perBase: units of each currency per one unit of base. Cross rates are
+    // triangulated through base. Rates that are not positive and finite are
+    // ignored, here and in update().
+    FxService(const std::string& base, const std::map<std::string, double>& perBase);
+
+    std::shared_ptr<const FxSnapshot> snapshot() const { return current.load(std::memory_order_acquire); }
+    const std::string& baseCurrency() const { return base; }
+
+    // Replaces/extends the quoted rates and publishes a new snapshot.
+    void update(const std::map<std::string, double>& perBase);
+
+    // Sum of all positions expressed in the reporting currency, in one pass.
+    static double total(const FxSnapshot& snap, const FxPositions& positions, int reporting);
+
+private:
+    void publish();
+
+    std::string base;
+    std::mutex writeMutex;
+    std::map<std::string, double> quotes;
+    std::atomic<std::shared_ptr<const FxSnapshot>> current;
+};
+
+#endif
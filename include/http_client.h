@@ -0,0 +1,76 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+struct HttpClientConfig {
+    std::string baseUrl = "https://www.alphavantage.co";
+    size_t maxConnections = 4;      // concurrent requests, also the size of the keep-alive pool
+    int requestsPerMinute = 75;     // 0 disables rate limiting
+    int maxRetries = 3;
+    int backoffMs = 250;            // doubled on every retry
+    int maxBackoffMs = 30000;       // caps the backoff and any Retry-After the server asks for
+    int timeoutMs = 10000;
+};
+
+struct HttpResponse {
+    int status = 0;
+    std::map<std::string, std::string> headers;
+    std::string body;
+    bool success = false;
+    std::string error_message;
+    double fetch_time_ms = 0.0;
+    int attempts = 0;
+};
+
+// Minimal HTTP/1.1 GET client with a keep-alive connection pool, a shared
+// request-rate schedule and retry with exponential backoff. https:// is
+// available when the build found OpenSSL.
+class HttpClient {
+public:
+    explicit HttpClient(const HttpClientConfig& config = HttpClientConfig());
+    ~HttpClient();
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    // pathAndQuery is appended to the base URL, e.g. "/query?function=...".
+    HttpResponse get(const std::string& pathAndQuery);
+    // Issues all requests concurrently, bounded by maxConnections. Results keep input order.
+    std::vector<HttpResponse> getMany(const std::vector<std::string>& paths);
+
+    const HttpClientConfig& config() const { return cfg; }
+    bool valid() const { return urlError.empty(); }
+    const std::string& error() const { return urlError; }
+
+    static std::string urlEncode(const std::string& s);
+
+private:
+    struct Connection;
+
+    std::unique_ptr<Connection> acquire(std::string& err, bool& reused);
+    void release(std::unique_ptr<Connection> conn, bool keepAlive);
+    std::unique_ptr<Connection> connect(std::string& err);
+    void waitForRateSlot();
+    bool attempt(const std::string& path, HttpResponse& resp, bool& retryable);
+
+    HttpClientConfig cfg;
+    std::string urlError;
+    bool tls;
+    std::string host;
+    int port;
+    std::string basePath;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<std::unique_ptr<Connection>> idle;
+    size_t inFlight;
+    std::chrono::steady_clock::time_point nextSlot;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef BONDS_PRICER_INSTRUMENT_H
+#define BONDS_PRICER_INSTRUMENT_H
+
+#include <vector>
+#include <variant>
+#include <cstddef>
+#include "curve.h"
+
+namespace Bonds {
+
+// Cashflow instruments as plain records. Payment dates count back from T in
+// steps of 1/freq (a fractional T gives a short first period), and everything
+// is discounted off a YieldCurve.
+
+struct FixedBullet {
+    double FV;
+    double c;
+    double T;
+    int freq;
+};
+
+// Floating-rate note paying (index + margin) * accrual. fixings[i] is the
+// known index rate for period i+1; later periods project the curve forward.
+struct FloatingRateNote {
+    double FV;
+    double margin;
+    double T;
+    int freq;
+    std::vector<double> fixings;
+};
+
+// Sinking-fund / amortizing bond. amortization[i] is the fraction of the
+// original FV repaid at the end of period i+1; the rest is repaid at T.
+struct Amortizer {
+    double FV;
+    double c;
+    double T;
+    int freq;
+    std::vector<double> amortization;
+};
+
+struct CouponStep {
+    double from;    // years; the rate applies to periods starting at or after this
+    double c;
+};
+
+// Step-up coupon bond. steps must be sorted by 'from'; the first step's rate
+// also covers any periods before it.
+struct StepUp {
+    double FV;
+    double T;
+    int freq;
+    std::vector<CouponStep> steps;
+};
+
+using Instrument = std::variant<FixedBullet, FloatingRateNote, Amortizer, StepUp>;
+
+double price(const FixedBullet& b, const YieldCurve& curve);
+double price(const FloatingRateNote& b, const YieldCurve& curve);
+double price(const Amortizer& b, const YieldCurve& curve);
+double price(const StepUp& b, const YieldCurve& curve);
+double price(const Instrument& inst, const YieldCurve& curve, Precision precision=Precision::Exact);
+
+struct Cashflow {
+    double time;
+    double amount;      // FRN coupons are projected off the curve
+    double discount;
+};
+
+void cashflows(const Instrument& inst, const YieldCurve& curve, std::vector<Cashflow>& out);
+
+// Prices a mixed book: instruments are bucketed by kind and each bucket runs
+// a direct (non-visiting) loop, so out[i] matches price(book[i], curve, precision).
+void priceBatch(const std::vector<Instrument>& book, const YieldCurve& curve, std::vector<double>& out,
+                Precision precision=Precision::Exact);
+void priceBatch(const Instrument* book, size_t n, const YieldCurve& curve, double* out,
+                Precision precision=Precision::Exact);
+
+}
+#endif
@@ -0,0 +1,85 @@
+#ifndef BONDS_PRICER_LATTICE_H
+#define BONDS_PRICER_LATTICE_H
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <tuple>
+#include "curve.h"
+
+namespace Bonds {
+
+struct ExerciseDate {
+    double time;    // years from today
+    double price;   // exercise price, in the same units as FV
+};
+
+// Fixed-coupon bond with optional Bermudan call (issuer) and put (holder)
+// schedules. Coupons fall on T - k/freq, so a fractional T gives a short first
+// period. Exercise is tested on the step nearest each date.
+struct CallableBond {
+    double FV;
+    double c;
+    double T;
+    int freq;
+    std::vector<ExerciseDate> calls;
+    std::vector<ExerciseDate> puts;
+};
+
+// Hull-White one-factor trinomial tree fitted to a zero curve. The tree is
+// immutable once built: level shifts, per-node one-step discount factors
+// (level-major, one contiguous row per step) and the branching probabilities
+// (which depend only on the node index) are shared by every bond priced on it.
+class HullWhiteLattice {
+public:
+    static std::shared_ptr<const HullWhiteLattice> build(const YieldCurve& curve, double meanReversion,
+                                                         double sigma, double horizon, int stepsPerYear=48);
+
+    // Present value of the bond. spread is added to every short rate (used for OAS).
+    double price(const CallableBond& bond, double spread=0.0) const;
+    void priceBatch(const std::vector<CallableBond>& bonds, std::vector<double>& out,
+                    size_t threads=0, double spread=0.0) const;
+
+    double dt() const { return step; }
+    int steps() const { return nSteps; }
+    double horizon() const { return nSteps * step; }
+    uint64_t curveVersion() const { return curveId; }
+
+private:
+    HullWhiteLattice() = default;
+    int widthAt(int m) const { return m < jmax ? m : jmax; }
+
+    double step;
+    int nSteps;
+    int jmax;
+    uint64_t curveId;
+    std::vector<double> disc;       // nSteps rows of (2*jmax+1)
+    std::vector<double> pu, pm, pd; // by j+jmax
+    std::vector<int> centre;        // middle successor of node j (j, or j-1 / j+1 at the edges)
+};
+
+// Shares lattices across callers that price against the same curve and model.
+// Holds at most capacity lattices; the least recently used one is dropped
+// first, so superseded curve versions age out.
+class LatticeCache {
+public:
+    explicit LatticeCache(size_t capacity = 8);
+
+    std::shared_ptr<const HullWhiteLattice> get(const YieldCurve& curve, double meanReversion,
+                                                double sigma, double horizon, int stepsPerYear=48);
+    void clear();
+    size_t size();
+
+private:
+    using Key = std::tuple<uint64_t, double, double, double, int>;
+    using Entry = std::pair<Key, std::shared_ptr<const HullWhiteLattice>>;
+    std::mutex mtx;
+    size_t capacity;
+    std::list<Entry> lru;   // most recently used at the front
+    std::map<Key, std::list<Entry>::iterator> lattices;
+};
+
+}
+#endif
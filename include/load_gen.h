@@ -0,0 +1,63 @@
+#ifndef LOAD_GEN_H
+#define LOAD_GEN_H
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+struct SyntheticBond {
+    double FV;
+    double c;
+    int T;
+    int freq;
+    double yield;   // current level of the random walk
+};
+
+struct Tick {
+    uint32_t instrument;    // index into the universe
+    double price;
+    int64_t publishNs;      // scheduled publish time, steady clock
+};
+
+struct FeedConfig {
+    uint64_t seed = 42;
+    size_t universe = 1000;
+    double tickRate = 10000;    // ticks per second, 0 = as fast as the pricer keeps up
+    double yieldVol = 0.0005;   // stdev of the yield change per tick
+};
+
+// Deterministic quote stream: the same seed gives the same universe and the
+// same tick sequence on every run.
+class SyntheticFeed {
+public:
+    explicit SyntheticFeed(const FeedConfig& config);
+
+    const std::vector<SyntheticBond>& universe() const { return bonds; }
+    Tick next(int64_t publishNs);
+
+private:
+    FeedConfig cfg;
+    std::mt19937_64 rng;
+    std::vector<SyntheticBond> bonds;
+};
+
+struct LoadTestConfig {
+    FeedConfig feed;
+    double durationSec = 5.0;
+    size_t workers = 1;
+};
+
+struct LoadTestReport {
+    uint64_t ticks;
+    double seconds;
+    double throughput;      // ticks per second priced
+    double p50Us, p90Us, p99Us, p999Us, maxUs;
+};
+
+// Publishes ticks on schedule and measures quote-to-risk latency: implied
+// yield, modified duration and convexity for the quoted bond. Latency is taken
+// from the scheduled publish time, so a pricer that falls behind is charged
+// for the queueing it causes.
+LoadTestReport runLoadTest(const LoadTestConfig& config);
+
+#endif
@@ -5,6 +5,11 @@
 #include <map>
 #include <vector>
 #include <chrono>
+#include <memory>
+#include <cstdint>
+#include "http_client.h"
+
+namespace Json { class Value; }
 
 struct MarketDataResult {
     std::map<std::string, double> data;
@@ -18,6 +23,13 @@ struct MarketDataResult {
 
 class MarketData {
 public:
+    // HTTP settings for the Alpha Vantage endpoints. ALPHA_BASE_URL (environment
+    // or .env) overrides the base URL, e.g. to point at a local stub server.
+    static void configure(const HttpClientConfig& config);
+    static void setApiKey(const std::string& key);
+    // Seeds the generator behind the mock fallback data, for reproducible runs.
+    static void setMockSeed(uint64_t seed);
+
     static MarketDataResult fetchStockData(const std::string& symbol);
     static MarketDataResult fetchBondData(const std::string& symbol);
     static std::vector<MarketDataResult> fetchMultipleStocks(const std::vector<std::string>& symbols);
@@ -35,6 +47,18 @@ public:
                                       double duration, double convexity, double ytm);
     
 private:
+    // The current client; a fetch keeps its snapshot alive across configure().
+    static std::shared_ptr<HttpClient> client();
+    static std::string apiKey();
+    static std::string stockPath(const std::string& symbol);
+    static std::string bondPath(const std::string& symbol);
+    static MarketDataResult stockFromResponse(const std::string& symbol, const HttpResponse& response);
+    static MarketDataResult bondFromResponse(const std::string& symbol, const HttpResponse& response);
+    static bool simulatedTreasuryQuote(const std::string& symbol, MarketDataResult& result);
+    static void parseStockSeries(const Json::Value& data, MarketDataResult& result);
+    static void parseGlobalQuote(const Json::Value& data, MarketDataResult& result);
+    static void applyStockMock(MarketDataResult& result);
+    static void applyBondMock(MarketDataResult& result);
     static std::vector<std::string> split(const std::string& s, char delimiter);
     static double safeStod(const std::string& str);
 };
@@ -0,0 +1,80 @@
+#ifndef BONDS_PRICER_PRICING_CACHE_H
+#define BONDS_PRICER_PRICING_CACHE_H
+
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Bonds {
+
+// Bond terms as used by zc_Bond / c_Bond. Use the factories so equivalent
+// terms hash identically (zero coupons carry c=0, freq=1).
+struct PricingKey {
+    bool coupon;
+    double FV;
+    double c;
+    double r;
+    int T;
+    int freq;
+
+    static PricingKey zeroCoupon(double face_value, double rate, int maturity);
+    static PricingKey couponBond(double face_value, double coupon_rate, double discount_rate, int maturity, int frequency);
+    bool operator==(const PricingKey& o) const;
+};
+
+struct PricingKeyHash {
+    size_t operator()(const PricingKey& k) const;
+};
+
+struct PricingResult {
+    double price;
+    double macaulay_duration;
+    double modified_duration;
+    double convexity;
+};
+
+// Sharded LRU memo of full pricing results. Each shard has its own lock and
+// capacity/shards entries; misses are priced outside the lock.
+class PricingCache {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        size_t size;
+        double hitRate() const { return hits + misses ? double(hits) / double(hits + misses) : 0.0; }
+    };
+
+    explicit PricingCache(size_t capacity = 4096, size_t shards = 16);
+
+    PricingResult get(const PricingKey& key);
+    bool lookup(const PricingKey& key, PricingResult& out);
+    void insert(const PricingKey& key, const PricingResult& value);
+    void clear();
+    Stats stats() const;
+
+    static PricingResult compute(const PricingKey& key);
+
+private:
+    using Entry = std::pair<PricingKey, PricingResult>;
+    struct Shard {
+        std::mutex mtx;
+        std::list<Entry> lru;   // most recently used at the front
+        std::unordered_map<PricingKey, std::list<Entry>::iterator, PricingKeyHash> index;
+    };
+
+    Shard& shardFor(size_t hash);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shardCapacity;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+    std::atomic<uint64_t> evictions;
+};
+
+}
+#endif
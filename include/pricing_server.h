@@ -0,0 +1,96 @@
+#ifndef PRICING_SERVER_H
+#define PRICING_SERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include "pricing_cache.h"
+
+struct ServerConfig {
+    std::string unixPath;           // listen on a Unix domain socket when set
+    std::string host = "127.0.0.1"; // otherwise TCP on host:port
+    int port = 7878;
+    size_t maxBatch = 1024;
+    size_t cacheCapacity = 4096;    // price/risk memo entries, 0 disables
+    size_t maxLineBytes = 1 << 20;  // longer request lines get an error and the client is dropped
+};
+
+// One JSON object per line in each direction. Requests:
+//   {"id":1,"op":"price|ytm|risk","type":"zc|coupon","FV":100,"c":0.05,"r":0.04,"T":10,"freq":2,"price":98.5}
+// Responses carry the request id and may arrive out of order:
+//   {"id":1,"ok":true,"price":...}  or  {"id":1,"ok":false,"error":"..."}
+// An optional "symbol" is echoed back as sent.
+// {"op":"stats"} reports pricing cache counters.
+// Revaluation: {"op":"reval",...terms...,"qty":N} adds the position to the
+// connection's running totals without a reply; {"id":2,"op":"total"} replies
+// {"id":2,"ok":true,"count":..,"pv":..,"dv01":..,"convexity":..,"errors":..}
+// and resets them. Totals are summed in the order the lines were sent.
+// Fields of the wrong JSON type, non-finite numbers and more than kMaxPeriods
+// coupon periods are rejected with an ok:false reply.
+struct PricingRequest {
+    enum class Op { Price, Ytm, Risk, Stats, Reval, Total };
+    // Bounds one request's work on the shared batch thread (100 years monthly is 1200).
+    static constexpr int64_t kMaxPeriods = 2400;
+    int64_t id = 0;
+    std::string symbol;
+    Op op = Op::Price;
+    bool coupon = true;
+    double FV = 0.0, c = 0.0, r = 0.0, marketPrice = 0.0, quantity = 1.0;
+    int T = 0, freq = 1;
+    std::string error;  // set when the line could not be parsed
+};
+
+class PricingServer {
+public:
+    explicit PricingServer(const ServerConfig& config);
+    ~PricingServer();
+
+    // Binds and listens; false (see error()) if the socket could not be opened.
+    bool listen();
+    // Serves until stop(), calling listen() first if needed; false if that fails.
+    bool run();
+    // Safe from any thread, before, during or after run().
+    void stop();
+    const std::string& error() const { return lastError; }
+
+    static bool parseRequest(const std::string& line, PricingRequest& req);
+    std::string evaluate(const PricingRequest& req);
+
+private:
+    struct Connection;
+    struct Pending {
+        std::shared_ptr<Connection> conn;
+        PricingRequest req;
+    };
+
+    void acceptLoop();
+    void readLoop(std::shared_ptr<Connection> conn);
+    void batchLoop();
+    void processBatch(std::vector<Pending>& batch);
+    void accumulate(Connection& conn, const PricingRequest& req);
+    std::string takeTotals(Connection& conn, const PricingRequest& req);
+
+    ServerConfig cfg;
+    std::string lastError;
+    std::unique_ptr<Bonds::PricingCache> cache;
+    std::mutex listenMutex;     // guards listenFd against stop() racing its close
+    int listenFd;
+    std::atomic<bool> running;
+    std::atomic<bool> stopRequested;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCv;
+    std::deque<Pending> queue;
+
+    std::mutex connMutex;
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::condition_variable readersDone;
+    size_t activeReaders;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef REVAL_COORDINATOR_H
+#define REVAL_COORDINATOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sys/types.h>
+#include "db_writer.h"
+
+struct RevalPosition {
+    std::string name;
+    bool coupon;
+    double FV, c, r;
+    int T, freq;
+    double quantity;
+};
+
+struct RevalConfig {
+    // Worker endpoints (Unix socket path or host:port), one shard each.
+    std::vector<std::string> endpoints;
+    // When endpoints is empty, start this many local `--serve` workers.
+    size_t spawn = 0;
+    std::string workerExe = "/proc/self/exe";
+    int maxRestarts = 2;        // per shard, after the first attempt
+    // Waiting for a shard's totals: timeoutMs plus timeoutPerPositionMs for
+    // each position in the shard, so large books don't time out.
+    int timeoutMs = 60000;
+    double timeoutPerPositionMs = 0.1;
+};
+
+struct ShardTotal {
+    size_t count = 0;
+    size_t errors = 0;
+    double pv = 0.0;
+    double dv01 = 0.0;
+    double convexity = 0.0;     // dollar convexity
+    int attempts = 0;
+};
+
+struct RevalReport {
+    bool success = false;
+    std::string error_message;
+    std::vector<ShardTotal> shards;
+    ShardTotal total;
+    size_t positions = 0;
+    double seconds = 0.0;
+};
+
+// Splits a book across pricing-server workers by a hash of the bond name,
+// streams each shard as "reval" lines, and merges the workers' totals in
+// shard order so the result does not depend on which shard finishes first.
+// A shard whose worker fails is resent from scratch, after restarting the
+// worker if this coordinator spawned it.
+class RevalCoordinator {
+public:
+    explicit RevalCoordinator(const RevalConfig& config);
+    ~RevalCoordinator();
+
+    RevalReport run(const std::vector<RevalPosition>& book);
+
+    static uint32_t shardOf(const std::string& name, size_t shards);
+    // Both loaders skip positions with non-finite terms or quantity and count
+    // them in skipped. run() counts any that reach it as errors.
+    static std::vector<RevalPosition> fromRecords(const std::vector<BondRecord>& rows, size_t* skipped=nullptr);
+    // CSV snapshot: name,type,FV,c,r,T,freq[,quantity]; type is "zc" / "Zero-Coupon"
+    // or anything else for a coupon bond. Lines that don't parse are skipped too.
+    static bool loadSnapshot(const std::string& path, std::vector<RevalPosition>& out, std::string& error,
+                             size_t* skipped=nullptr);
+
+private:
+    bool startWorker(size_t shard, std::string& error);
+    void stopWorker(size_t shard);
+    bool runShard(size_t shard, const std::string& payload, size_t positions, ShardTotal& out, std::string& error);
+
+    RevalConfig cfg;
+    std::vector<std::string> endpoints;
+    std::vector<pid_t> workers;     // empty unless spawned here
+};
+
+#endif
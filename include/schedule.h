@@ -0,0 +1,132 @@
+#ifndef BONDS_PRICER_SCHEDULE_H
+#define BONDS_PRICER_SCHEDULE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#include "curve.h"
+
+namespace Bonds {
+
+// Calendar date stored as days since 1970-01-01.
+class Date {
+public:
+    Date() : serial(0) {}
+    explicit Date(int32_t days) : serial(days) {}
+    Date(int year, int month, int day);
+
+    int32_t days() const { return serial; }
+    void ymd(int& year, int& month, int& day) const;
+    int weekday() const;                    // 0 = Monday ... 6 = Sunday
+    Date addMonths(int months) const;       // clamps to month end
+    Date addDays(int n) const { return Date(serial + n); }
+    bool isEndOfMonth() const;
+    std::string str() const;                // YYYY-MM-DD
+    static bool parse(const std::string& s, Date& out);
+
+    bool operator==(const Date& o) const { return serial == o.serial; }
+    bool operator<(const Date& o) const { return serial < o.serial; }
+    bool operator<=(const Date& o) const { return serial <= o.serial; }
+    int operator-(const Date& o) const { return serial - o.serial; }
+
+private:
+    int32_t serial;
+};
+
+enum class DayCount { ACT_ACT, THIRTY_360, ACT_360 };
+enum class BusinessDayConvention { Unadjusted, Following, ModifiedFollowing, Preceding };
+enum class StubType { ShortFront, LongFront, ShortBack, LongBack };
+
+// Year fraction between start and end. ACT/ACT is the ICMA rule and needs the
+// regular reference period containing the interval and the coupon frequency.
+double yearFraction(DayCount dc, Date start, Date end, Date refStart, Date refEnd, int freq);
+
+// Weekends plus an explicit holiday list.
+class Calendar {
+public:
+    explicit Calendar(std::string name = "WEEKENDS", std::vector<Date> holidays = {});
+    const std::string& name() const { return id; }
+    bool isBusinessDay(Date d) const;
+    Date adjust(Date d, BusinessDayConvention bdc) const;
+
+private:
+    std::string id;
+    std::vector<int32_t> holidays;  // sorted serials
+};
+
+struct ScheduleSpec {
+    Date issue;
+    Date maturity;
+    double faceValue = 100.0;
+    double coupon = 0.0;            // annual rate
+    int freq = 2;                   // must divide 12
+    DayCount dayCount = DayCount::ACT_ACT;
+    BusinessDayConvention convention = BusinessDayConvention::Following;
+    StubType stub = StubType::ShortFront;
+    std::shared_ptr<const Calendar> calendar;   // null = weekends only; cached by name
+
+    bool operator==(const ScheduleSpec& o) const;
+};
+
+struct ScheduleSpecHash {
+    size_t operator()(const ScheduleSpec& s) const;
+};
+
+// Generated once per set of terms and shared read-only. Per period: unadjusted
+// accrual start/end, adjusted payment date, full-period accrual fraction,
+// length in regular coupon periods (1 except for stubs, measured against the
+// notional regular periods) and cash amount (principal included in the last).
+struct Schedule {
+    double faceValue;
+    double coupon;
+    int freq;
+    int months;                 // regular period length
+    bool rollBackward;          // dates rolled back from maturity (front stubs)
+    DayCount dayCount;
+    std::vector<int32_t> accrualStart;
+    std::vector<int32_t> accrualEnd;
+    std::vector<int32_t> payDate;
+    std::vector<double> accrualFactor;
+    std::vector<double> periodLength;
+    std::vector<double> amount;
+
+    size_t size() const { return amount.size(); }
+    static std::shared_ptr<const Schedule> generate(const ScheduleSpec& spec);
+};
+
+struct DatedPrice {
+    double dirty;
+    double clean;
+    double accrued;
+};
+
+// Cash owed to the seller at settle for the coupon period containing it.
+double accruedInterest(const Schedule& s, Date settle);
+
+// Street-convention price at a yield compounded freq times a year: the next
+// cashflow is discounted over the regular periods left until it, each later
+// one over its own periodLength. The only date work is one binary search and
+// the fraction of the current period; the cashflow loop runs over
+// precomputed amounts.
+DatedPrice priceDated(const Schedule& s, Date settle, double yield);
+// Same cashflows discounted off a zero curve, each at its payment date's
+// ACT/365F time from settle.
+DatedPrice priceDated(const Schedule& s, Date settle, const YieldCurve& curve);
+
+// Shared store so instruments with identical terms share one Schedule.
+class ScheduleCache {
+public:
+    std::shared_ptr<const Schedule> get(const ScheduleSpec& spec);
+    size_t size() const;
+    void clear();
+
+private:
+    mutable std::mutex mtx;
+    std::unordered_map<ScheduleSpec, std::shared_ptr<const Schedule>, ScheduleSpecHash> schedules;
+};
+
+}
+#endif
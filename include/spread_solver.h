@@ -0,0 +1,45 @@
+#ifndef BONDS_PRICER_SPREAD_SOLVER_H
+#define BONDS_PRICER_SPREAD_SOLVER_H
+
+#include <vector>
+#include <cstdint>
+#include "curve.h"
+#include "instrument.h"
+#include "lattice.h"
+
+namespace Bonds {
+
+struct SpreadResult {
+    double spread;      // continuously compounded, added to every zero / short rate
+    int iterations;
+    bool converged;
+};
+
+// Solves spreads for a whole quote set at once. The solver remembers the
+// last spread per position and starts the next solve from it, so refreshing
+// a universe whose prices moved a little costs one or two iterations each.
+// Keep one solver per universe, with positions stable between calls.
+class SpreadSolver {
+public:
+    // Z-spread: PV of the cashflows off curve shifted by s equals prices[i].
+    void zSpreads(const std::vector<Instrument>& book, const std::vector<double>& prices,
+                  const YieldCurve& curve, std::vector<SpreadResult>& out);
+
+    // OAS: lattice price with every short rate shifted by s equals prices[i].
+    void oas(const HullWhiteLattice& lattice, const std::vector<CallableBond>& bonds,
+             const std::vector<double>& prices, std::vector<SpreadResult>& out, size_t threads=0);
+
+    void reset();
+
+private:
+    std::vector<double> lastZ;
+    std::vector<double> lastOas;
+    // Flattened (time, amount * discount) per cashflow; quote i owns [start[i], start[i+1]).
+    std::vector<double> cfTime;
+    std::vector<double> cfPv;
+    std::vector<uint32_t> start;
+    std::vector<Cashflow> scratch;
+};
+
+}
+#endif
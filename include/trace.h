@@ -0,0 +1,67 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Scoped wall-clock trace events written as Chrome/Perfetto "complete" events.
+// Each thread appends to its own buffer; buffers are only merged in dump().
+// Tracing must be switched on before worker threads start and dumped after
+// they have finished. When it is off a scope costs one relaxed load and a
+// predictable branch; build costly arguments only under isEnabled().
+namespace Trace {
+
+extern std::atomic<bool> enabled;
+
+inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+void start();
+bool dump(const std::string& path);
+
+// name, category and argName must be string literals (or otherwise outlive the dump).
+void record(const char* name, const char* category, int64_t startUs, int64_t durUs,
+            const char* argName, const std::string* argValue);
+
+inline int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class Scope {
+public:
+    Scope(const char* name, const char* category, const char* argName = nullptr, const std::string* arg = nullptr)
+        : eventName(nullptr) {
+        if (__builtin_expect(isEnabled(), 0)) {
+            eventName = name;
+            eventCategory = category;
+            argKey = argName;
+            argValue = arg;
+            startUs = nowUs();
+        }
+    }
+    ~Scope() {
+        if (__builtin_expect(eventName != nullptr, 0))
+            record(eventName, eventCategory, startUs, nowUs() - startUs, argKey, argValue);
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* eventName;
+    const char* eventCategory;
+    const char* argKey;
+    const std::string* argValue;    // must outlive the scope
+    int64_t startUs;
+};
+
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name, category) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+#define TRACE_SCOPE_ARG(name, category, argName, argValue) \
+    Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name, category, argName, &(argValue))
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef BONDS_PRICER_VAR_ENGINE_H
+#define BONDS_PRICER_VAR_ENGINE_H
+
+#include <string>
+#include <vector>
+#include "curve.h"
+#include "instrument.h"
+
+namespace Bonds {
+
+// Daily zero-rate moves at fixed tenors. The CSV's first row holds the
+// tenors in years, and each later row holds one day's moves in decimal.
+struct CurveHistory {
+    std::vector<double> tenors;
+    std::vector<std::vector<double>> moves;
+    bool success = false;
+    std::string error_message;
+
+    static CurveHistory loadCsv(const std::string& path);
+    // Move of scenario s at tenor t (linear between tenors, flat outside).
+    double moveAt(size_t s, double t) const;
+};
+
+struct Position {
+    Instrument instrument;
+    double quantity;
+};
+
+struct VarConfig {
+    double confidence = 0.99;
+    // Approximate P&L from duration and convexity with the scenario's move at
+    // each position's maturity instead of repricing every position.
+    bool deltaGamma = false;
+    size_t threads = 0;
+    size_t blockSize = 4096;    // positions per work item in full revaluation
+    Precision precision = Precision::Exact;     // discounting in full revaluation
+};
+
+struct VarReport {
+    bool success = false;
+    std::string error_message;
+    double basePv = 0.0;
+    double var = 0.0;           // loss at the confidence level, positive = loss
+    double es = 0.0;            // mean loss beyond VaR
+    std::vector<double> pnl;    // per scenario, in history order
+    double seconds = 0.0;
+};
+
+VarReport runHistoricalVar(const std::vector<Position>& book, const YieldCurve& base,
+                           const CurveHistory& history, const VarConfig& config = VarConfig());
+
+}
+#endif
@@ -0,0 +1,34 @@
+#ifndef BONDS_PRICER_YIELD_INVERTER_H
+#define BONDS_PRICER_YIELD_INVERTER_H
+
+#include <vector>
+#include "bond.h"
+
+namespace Bonds {
+
+// Per-instrument price-to-yield table for quote streams. Yield is fitted as a
+// Chebyshev series in log price over the band [yMin, yMax]; the series gives the
+// starting point and one or two Newton steps on the exact price finish it
+// (none when the measured fit error is already below 1e-12).
+// Prices outside the band fall back to c_Bond::ytm.
+class YieldInverter {
+public:
+    YieldInverter(const c_Bond& bond, double yMin=0.0, double yMax=0.20, int nodes=24);
+
+    double ytm(double marketPrice) const;
+    double guess(double marketPrice) const;
+    // False once the bond's cashflow terms differ from those the table was built for.
+    bool matches(const c_Bond& other) const;
+    const c_Bond& bond() const { return instrument; }
+    double fit_error() const { return fitError; }
+
+private:
+    c_Bond instrument;
+    double pLo, pHi;            // price band, pLo = price at yMax
+    double xLo, xHi;            // log of the band
+    std::vector<double> coeffs; // Chebyshev coefficients of y(log p) on [xLo, xHi]
+    double fitError;            // max |guess - ytm| measured over the band
+};
+
+}
+#endif
@@ -10,7 +10,7 @@ zc_Bond::zc_Bond(double face_value, double rate, int maturity) : Bond(face_value
 double zc_Bond::price() const { return FV / std::pow(1+r, T); }
 double zc_Bond::macaulay_duration() const { return T; }
 double zc_Bond::modified_duration() const { return T / (1+r); }
-double zc_Bond::convexity() const { return T*(T+1)/(1+r)*(1+r); }
+double zc_Bond::convexity() const { return T*(T+1)/((1+r)*(1+r)); }
 double zc_Bond::ytm(double marketPrice, int maxIter, double tol) const {
     double y = r;
     for(int i=0;i<maxIter;i++){
@@ -35,6 +35,29 @@ double c_Bond::price() const {
     return pv;
 }
 
+double c_Bond::price(Precision precision) const {
+    int n = T*freq;
+    if(precision==Precision::Exact || n > kFastMaxPeriods || !(r/freq > kFastMinRate)) return price();
+    double cf = FV*c/freq;
+    double L = fastLog1p(r/freq);
+    // Discount factors are filled a block at a time (a plain store loop, which
+    // vectorizes) and summed afterwards.
+    double df[64], sum = 0.0;
+    for(int i=1;i<=n;i+=64){
+        int m = std::min(64, n-i+1);
+        for(int k=0;k<m;k++)
+            df[k] = fastExp(-(i+k)*L);
+        for(int k=0;k<m;k++)
+            sum += df[k];
+    }
+    return cf*sum + FV*fastExp(-n*L);
+}
+
+void price_batch(const std::vector<c_Bond>& bonds, std::vector<double>& out, Precision precision) {
+    out.resize(bonds.size());
+    for(size_t i=0;i<bonds.size();i++) out[i] = bonds[i].price(precision);
+}
+
 double c_Bond::macaulay_duration() const {
     double dur=0.0;
     double P = price();
@@ -52,16 +75,32 @@ double c_Bond::convexity() const {
     for(int i=1;i<=T*freq;i++)
         conv += i*(i+1)*(FV*c/freq)/std::pow(1+r/freq,i)/P;
     conv += T*freq*(T*freq+1)*FV/std::pow(1+r/freq,T*freq)/P;
-    return conv/(freq*freq);
+    return conv/(freq*freq*std::pow(1+r/freq,2));
 }
 
 double c_Bond::current_yield(double marketPrice) const { return (FV*c)/marketPrice; }
 
+double c_Bond::price_at(double y, double* dPdy) const {
+    int n = T*freq;
+    double cf = FV*c/freq;
+    double v = 1.0/(1+y/freq);
+    double df = 1.0, pv = 0.0, weighted = 0.0;
+    for(int i=1;i<=n;i++){
+        df *= v;
+        pv += cf*df;
+        weighted += i*cf*df;
+    }
+    pv += FV*df;
+    weighted += n*FV*df;
+    if(dPdy) *dPdy = -weighted*v/freq;
+    return pv;
+}
+
 double c_Bond::ytm(double marketPrice, int maxIter, double tol) const {
     double y=r;
     for(int i=0;i<maxIter;i++){
-        double f=price()-marketPrice;
-        double df=-modified_duration();
+        double df;
+        double f=price_at(y, &df)-marketPrice;
         double y_new=y-f/df;
         if(std::abs(y_new-y)<tol) return y_new;
         y=y_new;
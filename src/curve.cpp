@@ -0,0 +1,70 @@
+#include "curve.h"
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+
+namespace Bonds {
+
+static std::atomic<uint64_t> nextCurveVersion{1};
+
+YieldCurve::YieldCurve(std::vector<double> tenors, std::vector<double> zeroRates)
+    : t(std::move(tenors)), z(std::move(zeroRates)), id(nextCurveVersion++) {
+    if (t.empty() || t.size() != z.size()) {
+        t = {1.0};
+        z = {z.empty() ? 0.0 : z.front()};
+    }
+}
+
+YieldCurve YieldCurve::flat(double rate) {
+    return YieldCurve({1.0}, {rate});
+}
+
+double YieldCurve::zero(double x) const {
+    if (x <= t.front()) return z.front();
+    if (x >= t.back()) return z.back();
+    size_t i = std::upper_bound(t.begin(), t.end(), x) - t.begin();
+    double w = (x - t[i-1]) / (t[i] - t[i-1]);
+    return z[i-1] + w * (z[i] - z[i-1]);
+}
+
+double YieldCurve::discount(double x, Precision precision) const {
+    double e = -zero(x) * x;
+    return precision == Precision::Fast ? fastExp(e) : std::exp(e);
+}
+
+void YieldCurve::discountGrid(double first, double step, int n, double* out, Precision precision) const {
+    size_t seg = 0;
+    for (int i = 0; i < n; i++) {
+        double x = first + i * step, r;
+        while (seg < t.size() && t[seg] < x) seg++;
+        if (seg == 0) r = z.front();
+        else if (seg == t.size()) r = z.back();
+        else r = z[seg-1] + (x - t[seg-1]) / (t[seg] - t[seg-1]) * (z[seg] - z[seg-1]);
+        out[i] = -r * x;
+    }
+    // Separate pass so the exponentials vectorize in Fast mode.
+    if (precision == Precision::Fast) {
+        for (int i = 0; i < n; i++) out[i] = fastExp(out[i]);
+    } else {
+        for (int i = 0; i < n; i++) out[i] = std::exp(out[i]);
+    }
+}
+
+double YieldCurve::forward(double t1, double t2) const {
+    if (t2 <= t1) return zero(t1);
+    return (zero(t2) * t2 - zero(t1) * t1) / (t2 - t1);
+}
+
+YieldCurve YieldCurve::shifted(const std::vector<double>& shifts) const {
+    std::vector<double> moved = z;
+    for (size_t i = 0; i < moved.size() && i < shifts.size(); i++) moved[i] += shifts[i];
+    return YieldCurve(t, moved);
+}
+
+YieldCurve YieldCurve::shifted(double parallel) const {
+    std::vector<double> moved = z;
+    for (auto& r : moved) r += parallel;
+    return YieldCurve(t, moved);
+}
+
+}
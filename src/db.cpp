@@ -1,8 +1,13 @@
 #include "db.h"
 #include <iostream>
+#include "trace.h"
+#include "db_functions.h"
 
 BondDB::BondDB(const std::string& filename) : dbFile(filename), db(nullptr) {}
-BondDB::~BondDB() { if(db) sqlite3_close(db); }
+BondDB::~BondDB() {
+    closeWriter();
+    if(db) sqlite3_close(db);
+}
 
 void BondDB::init() {
     sqlite3_open(dbFile.c_str(), &db);
@@ -18,17 +23,46 @@ void BondDB::init() {
         "price REAL,"
         "currency TEXT);";
     sqlite3_exec(db, sql, nullptr, nullptr, nullptr);
+    if(!registerBondFunctions(db))
+        std::cerr << "[WARN] Could not register bond SQL functions: " << sqlite3_errmsg(db) << "\n";
+}
+
+void BondDB::enableWriteBehind(const DBWriterConfig& config) {
+    closeWriter();
+    writer = std::make_unique<BondDBWriter>(dbFile, config);
 }
 
-void BondDB::saveBond(const std::string& name, const std::string& type,
+void BondDB::closeWriter() {
+    if(!writer) return;
+    writer->stop();
+    if(writer->dropped())
+        std::cerr << "[WARN] " << writer->dropped() << " queued bond rows were not saved: " << writer->lastError() << "\n";
+    writer.reset();
+}
+
+bool BondDB::flush() {
+    return writer ? writer->flush() : true;
+}
+
+std::string BondDB::lastError() const {
+    if(writer) return writer->lastError();
+    return db ? sqlite3_errmsg(db) : "database not open";
+}
+
+bool BondDB::saveBond(const std::string& name, const std::string& type,
                       double FV, double c, double r, int T, int freq,
                       double price, const std::string& currency) {
+    TRACE_SCOPE_ARG("saveBond", "db", "name", name);
+    if(writer)
+        return writer->enqueue({name, type, FV, c, r, T, freq, price, currency}) && !writer->failing();
     std::string sql="INSERT INTO bonds(name,type,FV,c,r,T,freq,price,currency) VALUES('"
         +name+"','"+type+"',"+std::to_string(FV)+","+std::to_string(c)+","+std::to_string(r)+","+std::to_string(T)+","+std::to_string(freq)+","+std::to_string(price)+",'"+currency+"');";
-    sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr);
+    return sqlite3_exec(db, sql.c_str(), nullptr, nullptr, nullptr)==SQLITE_OK;
 }
 
 std::vector<std::string> BondDB::listBonds() {
+    TRACE_SCOPE("listBonds", "db");
+    flush();
     std::vector<std::string> res;
     const char* sql="SELECT name FROM bonds;";
     sqlite3_stmt* stmt;
@@ -41,6 +75,8 @@ std::vector<std::string> BondDB::listBonds() {
 }
 
 std::vector<std::string> BondDB::searchBond(const std::string& name){
+    TRACE_SCOPE_ARG("searchBond", "db", "name", name);
+    flush();
     std::vector<std::string> res;
     std::string sql="SELECT name FROM bonds WHERE name LIKE '%"+name+"%';";
     sqlite3_stmt* stmt;
@@ -52,3 +88,48 @@ std::vector<std::string> BondDB::searchBond(const std::string& name){
     return res;
 }
 
+std::vector<BondRecord> BondDB::loadBonds() {
+    TRACE_SCOPE("loadBonds", "db");
+    flush();
+    std::vector<BondRecord> res;
+    const char* sql="SELECT name,type,FV,c,r,T,freq,price,currency FROM bonds ORDER BY id;";
+    sqlite3_stmt* stmt;
+    auto text = [&](int col) {
+        const unsigned char* t = sqlite3_column_text(stmt,col);
+        return std::string(t ? reinterpret_cast<const char*>(t) : "");
+    };
+    if(sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr)==SQLITE_OK){
+        while(sqlite3_step(stmt)==SQLITE_ROW)
+            res.push_back({text(0), text(1), sqlite3_column_double(stmt,2), sqlite3_column_double(stmt,3),
+                           sqlite3_column_double(stmt,4), sqlite3_column_int(stmt,5), sqlite3_column_int(stmt,6),
+                           sqlite3_column_double(stmt,7), text(8)});
+        sqlite3_finalize(stmt);
+    }
+    return res;
+}
+
+QueryResult BondDB::query(const std::string& sql) {
+    TRACE_SCOPE("query", "db");
+    flush();
+    QueryResult res{false, "", {}, {}};
+    sqlite3_stmt* stmt;
+    if(sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr)!=SQLITE_OK){
+        res.error_message = sqlite3_errmsg(db);
+        return res;
+    }
+    int n = sqlite3_column_count(stmt);
+    for(int i=0;i<n;i++) res.columns.push_back(sqlite3_column_name(stmt,i));
+    int rc;
+    while((rc=sqlite3_step(stmt))==SQLITE_ROW){
+        std::vector<std::string> row;
+        for(int i=0;i<n;i++){
+            const unsigned char* text = sqlite3_column_text(stmt,i);
+            row.push_back(text ? reinterpret_cast<const char*>(text) : "");
+        }
+        res.rows.push_back(std::move(row));
+    }
+    if(rc!=SQLITE_DONE) res.error_message = sqlite3_errmsg(db);
+    else res.success = true;
+    sqlite3_finalize(stmt);
+    return res;
+}
@@ -0,0 +1,100 @@
+#include "db_functions.h"
+#include "bond.h"
+#include <cmath>
+
+#ifndef SQLITE_INNOCUOUS
+#define SQLITE_INNOCUOUS 0
+#endif
+
+using Bonds::c_Bond;
+
+// Zero coupons are stored with c = 0 and freq = 1, which c_Bond prices the
+// same way as zc_Bond, so every row goes through c_Bond.
+static bool readBond(int argc, sqlite3_value** argv, bool withRate, c_Bond& out) {
+    for (int i = 0; i < argc; i++)
+        if (sqlite3_value_type(argv[i]) == SQLITE_NULL) return false;
+    double FV = sqlite3_value_double(argv[0]);
+    double c = sqlite3_value_double(argv[1]);
+    double r = withRate ? sqlite3_value_double(argv[2]) : c;
+    int T = sqlite3_value_int(argv[withRate ? 3 : 2]);
+    int freq = sqlite3_value_int(argv[withRate ? 4 : 3]);
+    if (T <= 0 || freq <= 0) return false;
+    out = c_Bond(FV, c, r, T, freq);
+    return true;
+}
+
+static void resultOrNull(sqlite3_context* ctx, double v) {
+    if (std::isfinite(v)) sqlite3_result_double(ctx, v);
+    else sqlite3_result_null(ctx);
+}
+
+static void bondPrice(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    c_Bond b;
+    if (readBond(argc, argv, true, b)) resultOrNull(ctx, b.price());
+    else sqlite3_result_null(ctx);
+}
+
+static void bondDuration(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    c_Bond b;
+    if (readBond(argc, argv, true, b)) resultOrNull(ctx, b.modified_duration());
+    else sqlite3_result_null(ctx);
+}
+
+static void bondConvexity(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    c_Bond b;
+    if (readBond(argc, argv, true, b)) resultOrNull(ctx, b.convexity());
+    else sqlite3_result_null(ctx);
+}
+
+static void bondYtm(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    c_Bond b;
+    if (!readBond(argc, argv, false, b)) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    double price = sqlite3_value_double(argv[4]);
+    resultOrNull(ctx, price > 0 ? b.ytm(price) : NAN);
+}
+
+struct Dv01Sum {
+    double total;
+    bool any;
+};
+
+static void dv01Step(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    Dv01Sum* acc = static_cast<Dv01Sum*>(sqlite3_aggregate_context(ctx, sizeof(Dv01Sum)));
+    c_Bond b;
+    if (!acc || !readBond(5, argv, true, b)) return;
+    double qty = argc > 5 && sqlite3_value_type(argv[5]) != SQLITE_NULL ? sqlite3_value_double(argv[5]) : 1.0;
+    double dv01 = b.price() * b.modified_duration() * 1e-4 * qty;
+    if (!std::isfinite(dv01)) return;
+    acc->total += dv01;
+    acc->any = true;
+}
+
+static void dv01Final(sqlite3_context* ctx) {
+    Dv01Sum* acc = static_cast<Dv01Sum*>(sqlite3_aggregate_context(ctx, 0));
+    if (acc && acc->any) sqlite3_result_double(ctx, acc->total);
+    else sqlite3_result_null(ctx);
+}
+
+bool registerBondFunctions(sqlite3* db) {
+    const int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS;
+    struct Scalar {
+        const char* name;
+        void (*fn)(sqlite3_context*, int, sqlite3_value**);
+    };
+    static const Scalar scalars[] = {
+        {"bond_price", bondPrice},
+        {"bond_ytm", bondYtm},
+        {"bond_duration", bondDuration},
+        {"bond_convexity", bondConvexity},
+    };
+    bool ok = true;
+    for (const auto& s : scalars)
+        ok &= sqlite3_create_function_v2(db, s.name, 5, flags, nullptr, s.fn, nullptr, nullptr, nullptr) == SQLITE_OK;
+    for (int nArg : {5, 6})
+        ok &= sqlite3_create_function_v2(db, "portfolio_dv01", nArg, flags, nullptr, nullptr,
+                                         dv01Step, dv01Final, nullptr) == SQLITE_OK;
+    return ok;
+}
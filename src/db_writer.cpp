@@ -0,0 +1,194 @@
+#include "db_writer.h"
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+#include "trace.h"
+#include "db_functions.h"
+
+BondDBWriter::BondDBWriter(const std::string& filename, const DBWriterConfig& config)
+    : dbFile(filename), cfg(config), db(nullptr), insert(nullptr),
+      enqueuedSeq(0), committedSeq(0), flushTarget(0), failedCommits(0), droppedRows(0),
+      lastFailed(false), stopping(false), finished(false) {
+    if (cfg.queueCapacity == 0) cfg.queueCapacity = 1;
+    if (cfg.batchSize == 0) cfg.batchSize = 1;
+    worker = std::thread(&BondDBWriter::run, this);
+}
+
+BondDBWriter::~BondDBWriter() {
+    stop();
+    close();
+}
+
+void BondDBWriter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    notFull.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+bool BondDBWriter::enqueue(BondRecord rec) {
+    std::unique_lock<std::mutex> lock(mtx);
+    notFull.wait(lock, [this] { return queue.size() < cfg.queueCapacity || stopping; });
+    if (stopping) return false;
+    queue.push_back(std::move(rec));
+    enqueuedSeq++;
+    if (queue.size() == 1 || queue.size() >= cfg.batchSize) notEmpty.notify_one();
+    return true;
+}
+
+bool BondDBWriter::tryEnqueue(BondRecord rec) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (stopping || queue.size() >= cfg.queueCapacity) return false;
+    queue.push_back(std::move(rec));
+    enqueuedSeq++;
+    if (queue.size() == 1 || queue.size() >= cfg.batchSize) notEmpty.notify_one();
+    return true;
+}
+
+bool BondDBWriter::flush() {
+    std::unique_lock<std::mutex> lock(mtx);
+    uint64_t target = enqueuedSeq;
+    if (committedSeq >= target) return true;
+    uint64_t failedBefore = failedCommits;
+    flushTarget = std::max(flushTarget, target);
+    notEmpty.notify_one();
+    progress.wait(lock, [&] { return committedSeq >= target || failedCommits != failedBefore || finished; });
+    return committedSeq >= target;
+}
+
+size_t BondDBWriter::pending() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return queue.size();
+}
+
+bool BondDBWriter::failing() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return lastFailed;
+}
+
+uint64_t BondDBWriter::dropped() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return droppedRows;
+}
+
+std::string BondDBWriter::lastError() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return error;
+}
+
+void BondDBWriter::close() {
+    if (insert) sqlite3_finalize(insert);
+    if (db) sqlite3_close(db);
+    insert = nullptr;
+    db = nullptr;
+}
+
+bool BondDBWriter::open() {
+    close();
+    if (sqlite3_open(dbFile.c_str(), &db) != SQLITE_OK) return false;
+    // WAL lets BondDB's reader connection proceed while a batch commits.
+    sqlite3_exec(db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+    const char* sync = cfg.durability == Durability::Off ? "PRAGMA synchronous=OFF;"
+                     : cfg.durability == Durability::Full ? "PRAGMA synchronous=FULL;"
+                     : "PRAGMA synchronous=NORMAL;";
+    sqlite3_exec(db, sync, nullptr, nullptr, nullptr);
+    sqlite3_busy_timeout(db, 5000);
+    // Indexes, views and triggers may call the bond_* functions, and inserts
+    // evaluate them on this connection too.
+    if (!registerBondFunctions(db)) return false;
+    const char* sql = "INSERT INTO bonds(name,type,FV,c,r,T,freq,price,currency) VALUES(?,?,?,?,?,?,?,?,?);";
+    return sqlite3_prepare_v2(db, sql, -1, &insert, nullptr) == SQLITE_OK;
+}
+
+bool BondDBWriter::commitBatch(std::deque<BondRecord>& batch, std::string& why) {
+    std::string rows;
+    if (Trace::isEnabled()) rows = std::to_string(batch.size());
+    TRACE_SCOPE_ARG("commitBatch", "db", "rows", rows);
+    if (sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        why = sqlite3_errmsg(db);
+        return false;
+    }
+    for (const auto& rec : batch) {
+        sqlite3_bind_text(insert, 1, rec.name.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(insert, 2, rec.type.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_double(insert, 3, rec.FV);
+        sqlite3_bind_double(insert, 4, rec.c);
+        sqlite3_bind_double(insert, 5, rec.r);
+        sqlite3_bind_int(insert, 6, rec.T);
+        sqlite3_bind_int(insert, 7, rec.freq);
+        sqlite3_bind_double(insert, 8, rec.price);
+        sqlite3_bind_text(insert, 9, rec.currency.c_str(), -1, SQLITE_TRANSIENT);
+        int rc = sqlite3_step(insert);
+        sqlite3_reset(insert);
+        if (rc != SQLITE_DONE) {
+            why = sqlite3_errmsg(db);
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK) return true;
+    why = sqlite3_errmsg(db);
+    sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+    return false;
+}
+
+void BondDBWriter::run() {
+    bool ok = open();
+    std::deque<BondRecord> batch;
+    std::string why;
+    std::unique_lock<std::mutex> lock(mtx);
+    int backoffMs = 0, retriesLeft = cfg.shutdownRetries;
+
+    while (true) {
+        notEmpty.wait(lock, [this] { return !queue.empty() || stopping; });
+        if (queue.empty() && stopping) break;
+
+        if (backoffMs > 0 && !stopping) {
+            // Back off after a failure; new rows keep queueing behind the failed ones.
+            notEmpty.wait_for(lock, std::chrono::milliseconds(backoffMs), [this] { return stopping; });
+        } else {
+            // Give a partial batch until the interval elapses to fill up, unless
+            // someone is waiting on it or we are shutting down.
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(cfg.flushIntervalMs);
+            notEmpty.wait_until(lock, deadline, [this] {
+                return queue.size() >= cfg.batchSize || stopping || flushTarget > committedSeq;
+            });
+        }
+
+        batch.swap(queue);
+        notFull.notify_all();
+        lock.unlock();
+
+        if (!ok) ok = open();
+        bool committed = ok && commitBatch(batch, why);
+
+        lock.lock();
+        if (committed) {
+            committedSeq += batch.size();
+            batch.clear();
+            lastFailed = false;
+            backoffMs = 0;
+        } else {
+            error = ok ? "batch commit failed: " + why : "cannot open " + dbFile + " for writing";
+            failedCommits++;
+            lastFailed = true;
+            backoffMs = std::min(std::max(10, backoffMs * 2), std::max(10, cfg.maxBackoffMs));
+            if (stopping && --retriesLeft < 0) {
+                droppedRows += batch.size() + queue.size();
+                queue.clear();
+                batch.clear();
+            } else {
+                // Keep the failed rows ahead of anything queued since, in order.
+                queue.insert(queue.begin(), std::make_move_iterator(batch.begin()),
+                             std::make_move_iterator(batch.end()));
+                batch.clear();
+            }
+        }
+        progress.notify_all();
+    }
+    finished = true;
+    progress.notify_all();
+}
@@ -0,0 +1,67 @@
+#include "fx.h"
+#include <cmath>
+
+using namespace std;
+
+int FxSnapshot::index(const string& currency) const {
+    for (size_t i = 0; i < currencies.size(); i++)
+        if (currencies[i] == currency) return (int)i;
+    return -1;
+}
+
+double FxSnapshot::rate(const string& from, const string& to) const {
+    int f = index(from), t = index(to);
+    if (f < 0 || t < 0) return NAN;
+    return rate(f, t);
+}
+
+static bool usableRate(double rate) {
+    return rate > 0 && isfinite(rate);
+}
+
+FxService::FxService(const string& baseCurrency, const map<string, double>& perBase) : base(baseCurrency) {
+    for (const auto& [ccy, rate] : perBase)
+        if (usableRate(rate)) quotes[ccy] = rate;
+    quotes[base] = 1.0;
+    publish();
+}
+
+void FxService::update(const map<string, double>& perBase) {
+    lock_guard<mutex> lock(writeMutex);
+    for (const auto& [ccy, rate] : perBase)
+        if (usableRate(rate)) quotes[ccy] = rate;
+    quotes[base] = 1.0;
+    publish();
+}
+
+void FxService::publish() {
+    auto snap = make_shared<FxSnapshot>();
+    auto prev = current.load(memory_order_acquire);
+    snap->version = prev ? prev->version + 1 : 1;
+
+    // Keep existing indices stable so callers may cache them across snapshots.
+    if (prev) snap->currencies = prev->currencies;
+    for (const auto& [ccy, rate] : quotes)
+        if (snap->index(ccy) < 0) snap->currencies.push_back(ccy);
+
+    size_t n = snap->size();
+    vector<double> perBase(n);
+    for (size_t i = 0; i < n; i++) perBase[i] = quotes.at(snap->currencies[i]);
+
+    snap->matrix.resize(n * n);
+    for (size_t to = 0; to < n; to++)
+        for (size_t from = 0; from < n; from++)
+            snap->matrix[to * n + from] = perBase[to] / perBase[from];
+
+    current.store(std::move(snap), memory_order_release);
+}
+
+double FxService::total(const FxSnapshot& snap, const FxPositions& positions, int reporting) {
+    const double* rate = snap.toCurrency(reporting);
+    const int* ccy = positions.currency.data();
+    const double* amt = positions.amount.data();
+    size_t n = positions.size();
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += amt[i] * rate[ccy[i]];
+    return sum;
+}
@@ -0,0 +1,387 @@
+#include "http_client.h"
+#include "trace.h"
+#include <cstring>
+#include <cctype>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#ifdef BOND_PRICER_HAVE_OPENSSL
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#endif
+
+using namespace std;
+
+#ifdef BOND_PRICER_HAVE_OPENSSL
+static SSL_CTX* sslContext() {
+    static SSL_CTX* ctx = [] {
+        SSL_CTX* c = SSL_CTX_new(TLS_client_method());
+        if (c) {
+            SSL_CTX_set_default_verify_paths(c);
+            SSL_CTX_set_verify(c, SSL_VERIFY_PEER, nullptr);
+        }
+        return c;
+    }();
+    return ctx;
+}
+#endif
+
+struct HttpClient::Connection {
+    int fd = -1;
+#ifdef BOND_PRICER_HAVE_OPENSSL
+    SSL* ssl = nullptr;
+#endif
+    string pending;     // bytes read past the end of the previous response
+
+    ~Connection() {
+#ifdef BOND_PRICER_HAVE_OPENSSL
+        if (ssl) { SSL_shutdown(ssl); SSL_free(ssl); }
+#endif
+        if (fd >= 0) close(fd);
+    }
+
+    bool sendAll(const string& data) {
+        size_t off = 0;
+        while (off < data.size()) {
+            ssize_t n;
+#ifdef BOND_PRICER_HAVE_OPENSSL
+            if (ssl) n = SSL_write(ssl, data.data() + off, (int)(data.size() - off));
+            else
+#endif
+            n = ::send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            off += (size_t)n;
+        }
+        return true;
+    }
+
+    // Appends whatever is available to pending; false on EOF, error or timeout.
+    bool fill() {
+        char buf[16384];
+        ssize_t n;
+#ifdef BOND_PRICER_HAVE_OPENSSL
+        if (ssl) n = SSL_read(ssl, buf, sizeof(buf));
+        else
+#endif
+        n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) return false;
+        pending.append(buf, (size_t)n);
+        return true;
+    }
+};
+
+static string lower(string s) {
+    for (auto& ch : s) ch = (char)tolower((unsigned char)ch);
+    return s;
+}
+
+HttpClient::HttpClient(const HttpClientConfig& config)
+    : cfg(config), tls(false), port(80), inFlight(0), nextSlot(chrono::steady_clock::now()) {
+    if (cfg.maxConnections == 0) cfg.maxConnections = 1;
+
+    string url = cfg.baseUrl;
+    auto schemeEnd = url.find("://");
+    if (schemeEnd == string::npos) {
+        urlError = "Invalid base URL: " + url;
+        return;
+    }
+    string scheme = lower(url.substr(0, schemeEnd));
+    if (scheme == "https") {
+#ifdef BOND_PRICER_HAVE_OPENSSL
+        tls = true;
+        port = 443;
+#else
+        urlError = "https:// requires a build with OpenSSL";
+        return;
+#endif
+    } else if (scheme != "http") {
+        urlError = "Unsupported URL scheme: " + scheme;
+        return;
+    }
+
+    string rest = url.substr(schemeEnd + 3);
+    auto slash = rest.find('/');
+    string authority = rest.substr(0, slash);
+    basePath = slash == string::npos ? "" : rest.substr(slash);
+    while (!basePath.empty() && basePath.back() == '/') basePath.pop_back();
+
+    auto colon = authority.rfind(':');
+    if (colon != string::npos) {
+        host = authority.substr(0, colon);
+        port = atoi(authority.c_str() + colon + 1);
+    } else {
+        host = authority;
+    }
+    if (host.empty() || port <= 0) urlError = "Invalid base URL: " + url;
+}
+
+HttpClient::~HttpClient() = default;
+
+string HttpClient::urlEncode(const string& s) {
+    static const char* hex = "0123456789ABCDEF";
+    string out;
+    for (unsigned char ch : s) {
+        if (isalnum(ch) || ch == '-' || ch == '_' || ch == '.' || ch == '~') {
+            out += (char)ch;
+        } else {
+            out += '%';
+            out += hex[ch >> 4];
+            out += hex[ch & 15];
+        }
+    }
+    return out;
+}
+
+unique_ptr<HttpClient::Connection> HttpClient::connect(string& err) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    int rc = getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &res);
+    if (rc != 0) {
+        err = "DNS lookup failed for " + host + ": " + gai_strerror(rc);
+        return nullptr;
+    }
+
+    auto conn = make_unique<Connection>();
+    for (addrinfo* ai = res; ai; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        timeval tv{cfg.timeoutMs / 1000, (cfg.timeoutMs % 1000) * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            conn->fd = fd;
+            break;
+        }
+        close(fd);
+    }
+    freeaddrinfo(res);
+    if (conn->fd < 0) {
+        err = "Could not connect to " + host + ":" + to_string(port);
+        return nullptr;
+    }
+
+#ifdef BOND_PRICER_HAVE_OPENSSL
+    if (tls) {
+        SSL_CTX* ctx = sslContext();
+        conn->ssl = ctx ? SSL_new(ctx) : nullptr;
+        if (!conn->ssl) {
+            err = "TLS initialisation failed";
+            return nullptr;
+        }
+        SSL_set_fd(conn->ssl, conn->fd);
+        SSL_set_tlsext_host_name(conn->ssl, host.c_str());
+        SSL_set1_host(conn->ssl, host.c_str());
+        if (SSL_connect(conn->ssl) != 1) {
+            err = "TLS handshake with " + host + " failed";
+            return nullptr;
+        }
+    }
+#endif
+    return conn;
+}
+
+unique_ptr<HttpClient::Connection> HttpClient::acquire(string& err, bool& reused) {
+    {
+        unique_lock<mutex> lock(mtx);
+        cv.wait(lock, [this] { return inFlight < cfg.maxConnections; });
+        inFlight++;
+        if (!idle.empty()) {
+            auto conn = std::move(idle.back());
+            idle.pop_back();
+            reused = true;
+            return conn;
+        }
+    }
+    reused = false;
+    auto conn = connect(err);
+    if (!conn) {
+        lock_guard<mutex> lock(mtx);
+        inFlight--;
+        cv.notify_one();
+    }
+    return conn;
+}
+
+void HttpClient::release(unique_ptr<Connection> conn, bool keepAlive) {
+    lock_guard<mutex> lock(mtx);
+    if (conn && keepAlive && conn->pending.empty()) idle.push_back(std::move(conn));
+    inFlight--;
+    cv.notify_one();
+}
+
+void HttpClient::waitForRateSlot() {
+    if (cfg.requestsPerMinute <= 0) return;
+    auto interval = chrono::microseconds(60000000 / cfg.requestsPerMinute);
+    chrono::steady_clock::time_point slot;
+    {
+        lock_guard<mutex> lock(mtx);
+        slot = max(chrono::steady_clock::now(), nextSlot);
+        nextSlot = slot + interval;
+    }
+    this_thread::sleep_until(slot);
+}
+
+bool HttpClient::attempt(const string& path, HttpResponse& resp, bool& retryable) {
+    retryable = true;
+    resp.status = 0;
+    resp.headers.clear();
+    resp.body.clear();
+
+    // A pooled connection may have been closed by the server while idle; that
+    // shows up as a failure before any response bytes and is retried once on a
+    // fresh connection without counting against maxRetries.
+    for (int fresh = 0; fresh < 2; fresh++) {
+        string err;
+        bool reused = false;
+        auto conn = acquire(err, reused);
+        if (!conn) {
+            resp.error_message = err;
+            return false;
+        }
+
+        string request = "GET " + basePath + path + " HTTP/1.1\r\n"
+            "Host: " + host + "\r\n"
+            "User-Agent: bond_pricer\r\n"
+            "Accept: application/json\r\n"
+            "Connection: keep-alive\r\n\r\n";
+
+        if (!conn->sendAll(request)) {
+            release(nullptr, false);
+            if (reused) continue;
+            resp.error_message = "Failed to send request";
+            return false;
+        }
+
+        string& buf = conn->pending;
+        size_t headerEnd;
+        bool gotBytes = !buf.empty();
+        while ((headerEnd = buf.find("\r\n\r\n")) == string::npos) {
+            if (!conn->fill()) break;
+            gotBytes = true;
+        }
+        if (headerEnd == string::npos) {
+            release(nullptr, false);
+            if (reused && !gotBytes) continue;
+            resp.error_message = "Connection closed before response headers";
+            return false;
+        }
+
+        // Status line and headers
+        string head = buf.substr(0, headerEnd);
+        buf.erase(0, headerEnd + 4);
+        size_t lineEnd = head.find("\r\n");
+        string statusLine = head.substr(0, lineEnd);
+        auto sp = statusLine.find(' ');
+        resp.status = sp == string::npos ? 0 : atoi(statusLine.c_str() + sp + 1);
+        size_t pos = lineEnd == string::npos ? head.size() : lineEnd + 2;
+        while (pos < head.size()) {
+            size_t next = head.find("\r\n", pos);
+            if (next == string::npos) next = head.size();
+            string hdr = head.substr(pos, next - pos);
+            auto colon = hdr.find(':');
+            if (colon != string::npos) {
+                string value = hdr.substr(colon + 1);
+                value.erase(0, value.find_first_not_of(" \t"));
+                resp.headers[lower(hdr.substr(0, colon))] = value;
+            }
+            pos = next + 2;
+        }
+
+        bool keepAlive = lower(resp.headers["connection"]) != "close";
+        bool ok = true;
+        if (lower(resp.headers["transfer-encoding"]).find("chunked") != string::npos) {
+            while (true) {
+                size_t crlf;
+                while ((crlf = buf.find("\r\n")) == string::npos && (ok = conn->fill())) {}
+                if (!ok) break;
+                size_t chunk = strtoul(buf.c_str(), nullptr, 16);
+                buf.erase(0, crlf + 2);
+                while (buf.size() < chunk + 2 && (ok = conn->fill())) {}
+                if (!ok) break;
+                resp.body.append(buf, 0, chunk);
+                buf.erase(0, chunk + 2);
+                if (chunk == 0) break;
+            }
+        } else if (resp.headers.count("content-length")) {
+            size_t len = strtoul(resp.headers["content-length"].c_str(), nullptr, 10);
+            while (buf.size() < len && (ok = conn->fill())) {}
+            if (ok) {
+                resp.body = buf.substr(0, len);
+                buf.erase(0, len);
+            }
+        } else {
+            while (conn->fill()) {}
+            resp.body = std::move(buf);
+            buf.clear();
+            keepAlive = false;
+        }
+
+        if (!ok) {
+            release(nullptr, false);
+            resp.error_message = "Connection closed mid-response";
+            return false;
+        }
+        release(std::move(conn), keepAlive);
+
+        if (resp.status == 200) return true;
+        resp.error_message = "HTTP " + to_string(resp.status);
+        retryable = resp.status == 429 || resp.status >= 500;
+        return false;
+    }
+    resp.error_message = "Connection reset by server";
+    return false;
+}
+
+HttpResponse HttpClient::get(const string& pathAndQuery) {
+    TRACE_SCOPE("http_get", "fetch");
+    HttpResponse resp;
+    if (!valid()) {
+        resp.error_message = urlError;
+        return resp;
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i <= cfg.maxRetries; i++) {
+        waitForRateSlot();
+        resp.attempts = i + 1;
+        bool retryable = false;
+        if (attempt(pathAndQuery, resp, retryable)) {
+            resp.success = true;
+            resp.error_message.clear();
+            break;
+        }
+        if (!retryable || i == cfg.maxRetries) break;
+
+        int64_t delayMs = (int64_t)cfg.backoffMs << min(i, 30);
+        auto retryAfter = resp.headers.find("retry-after");
+        if (retryAfter != resp.headers.end()) delayMs = max<int64_t>(delayMs, atoll(retryAfter->second.c_str()) * 1000);
+        this_thread::sleep_for(chrono::milliseconds(min<int64_t>(delayMs, cfg.maxBackoffMs)));
+    }
+    resp.fetch_time_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    return resp;
+}
+
+vector<HttpResponse> HttpClient::getMany(const vector<string>& paths) {
+    vector<HttpResponse> results(paths.size());
+    atomic<size_t> next{0};
+    size_t workers = min(cfg.maxConnections, paths.size());
+    vector<thread> pool;
+    for (size_t w = 0; w < workers; w++) {
+        pool.emplace_back([&] {
+            for (size_t i = next++; i < paths.size(); i = next++)
+                results[i] = get(paths[i]);
+        });
+    }
+    for (auto& t : pool) t.join();
+    return results;
+}
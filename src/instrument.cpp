@@ -0,0 +1,125 @@
+#include "instrument.h"
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+
+namespace Bonds {
+
+// Number of coupons on or before T, counting back from maturity.
+static int periods(double T, int freq) {
+    return freq > 0 && T > 0 ? (int)std::ceil(T * freq - 1e-9) : 0;
+}
+
+// Every kind pays on the grid T - k/freq, so discount factors for the whole
+// grid are computed up front (df[i-1] for period i, paid at first + (i-1)/freq).
+// Each kind then walks its cashflows once and hands (time, amount, discount
+// factor) to fn; pricing and cashflow extraction share these loops.
+template <class Fn>
+static void walk(const FixedBullet& b, int n, double first, const double* df, Fn&& fn) {
+    double coupon = b.FV * b.c / b.freq;
+    for (int i = 1; i <= n; i++)
+        fn(first + (double)(i - 1) / b.freq, i == n ? coupon + b.FV : coupon, df[i - 1]);
+}
+
+// Projected rates span the actual interval between payments, so a short
+// first period still reads the right forward off the curve.
+template <class Fn>
+static void walk(const FloatingRateNote& b, int n, double first, const double* df, Fn&& fn) {
+    double tau = 1.0 / b.freq, prevDf = 1.0, prevT = 0.0;
+    for (int i = 1; i <= n; i++) {
+        double t = first + (i - 1) * tau;
+        double index = (size_t)(i - 1) < b.fixings.size() ? b.fixings[i - 1] : (prevDf / df[i - 1] - 1.0) / (t - prevT);
+        double amount = b.FV * (index + b.margin) * tau;
+        fn(t, i == n ? amount + b.FV : amount, df[i - 1]);
+        prevDf = df[i - 1];
+        prevT = t;
+    }
+}
+
+template <class Fn>
+static void walk(const Amortizer& b, int n, double first, const double* df, Fn&& fn) {
+    double outstanding = b.FV;
+    for (int i = 1; i <= n; i++) {
+        double repaid = i == n ? outstanding
+                               : (size_t)(i - 1) < b.amortization.size() ? b.FV * b.amortization[i - 1] : 0.0;
+        if (repaid > outstanding) repaid = outstanding;
+        fn(first + (double)(i - 1) / b.freq, outstanding * b.c / b.freq + repaid, df[i - 1]);
+        outstanding -= repaid;
+    }
+}
+
+template <class Fn>
+static void walk(const StepUp& b, int n, double first, const double* df, Fn&& fn) {
+    if (b.steps.empty()) return;
+    size_t s = 0;
+    for (int i = 1; i <= n; i++) {
+        double t = first + (double)(i - 1) / b.freq, start = std::max(0.0, t - 1.0 / b.freq);
+        while (s + 1 < b.steps.size() && b.steps[s + 1].from <= start + 1e-9) s++;
+        double coupon = b.FV * b.steps[s].c / b.freq;
+        fn(t, i == n ? coupon + b.FV : coupon, df[i - 1]);
+    }
+}
+
+template <class B, class Fn>
+static void walk(const B& b, const YieldCurve& curve, Precision pr, Fn&& fn) {
+    int n = periods(b.T, b.freq);
+    if (n <= 0) return;
+    if (n > kFastMaxPeriods) pr = Precision::Exact;     // outside the kFastPriceRelError domain
+    thread_local std::vector<double> grid;
+    grid.resize(n);
+    double first = b.T - (double)(n - 1) / b.freq;
+    curve.discountGrid(first, 1.0 / b.freq, n, grid.data(), pr);
+    walk(b, n, first, grid.data(), fn);
+}
+
+template <class B>
+static double pv(const B& b, const YieldCurve& curve, Precision pr = Precision::Exact) {
+    double sum = 0.0;
+    walk(b, curve, pr, [&](double, double amount, double df) { sum += amount * df; });
+    return sum;
+}
+
+double price(const FixedBullet& b, const YieldCurve& curve) { return pv(b, curve); }
+double price(const FloatingRateNote& b, const YieldCurve& curve) { return pv(b, curve); }
+double price(const Amortizer& b, const YieldCurve& curve) { return pv(b, curve); }
+double price(const StepUp& b, const YieldCurve& curve) { return pv(b, curve); }
+
+double price(const Instrument& inst, const YieldCurve& curve, Precision precision) {
+    return std::visit([&](const auto& b) { return pv(b, curve, precision); }, inst);
+}
+
+void cashflows(const Instrument& inst, const YieldCurve& curve, std::vector<Cashflow>& out) {
+    out.clear();
+    std::visit([&](const auto& b) {
+        walk(b, curve, Precision::Exact, [&](double t, double amount, double df) { out.push_back({t, amount, df}); });
+    }, inst);
+}
+
+template <size_t K>
+static void priceKind(const Instrument* book, const std::vector<uint32_t>& idx,
+                      const YieldCurve& curve, Precision pr, double* out) {
+    for (uint32_t i : idx) out[i] = pv(*std::get_if<K>(&book[i]), curve, pr);
+}
+
+template <size_t... K>
+static void priceKinds(const Instrument* book, const std::vector<uint32_t>* buckets,
+                       const YieldCurve& curve, Precision pr, double* out, std::index_sequence<K...>) {
+    (priceKind<K>(book, buckets[K], curve, pr, out), ...);
+}
+
+void priceBatch(const Instrument* book, size_t n, const YieldCurve& curve, double* out, Precision precision) {
+    constexpr size_t kinds = std::variant_size_v<Instrument>;
+    thread_local std::vector<uint32_t> buckets[kinds];
+    for (auto& b : buckets) b.clear();
+    for (uint32_t i = 0; i < n; i++) buckets[book[i].index()].push_back(i);
+    priceKinds(book, buckets, curve, precision, out, std::make_index_sequence<kinds>{});
+}
+
+void priceBatch(const std::vector<Instrument>& book, const YieldCurve& curve, std::vector<double>& out,
+                Precision precision) {
+    out.resize(book.size());
+    priceBatch(book.data(), book.size(), curve, out.data(), precision);
+}
+
+}
@@ -0,0 +1,181 @@
+#include "lattice.h"
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <algorithm>
+
+namespace Bonds {
+
+std::shared_ptr<const HullWhiteLattice> HullWhiteLattice::build(const YieldCurve& curve, double a,
+                                                                double sigma, double horizon, int stepsPerYear) {
+    std::shared_ptr<HullWhiteLattice> lat(new HullWhiteLattice());
+    if (stepsPerYear <= 0) stepsPerYear = 48;
+    lat->step = 1.0 / stepsPerYear;
+    lat->nSteps = std::max(1, (int)std::ceil(horizon * stepsPerYear - 1e-9));
+    lat->curveId = curve.version();
+    double dt = lat->step;
+    int N = lat->nSteps;
+
+    // Hull & White (1994): x-tree with spacing sqrt(3V), truncated at jmax.
+    double M = a > 0 ? std::exp(-a * dt) - 1.0 : 0.0;
+    double V = a > 0 ? sigma * sigma * (1.0 - std::exp(-2.0 * a * dt)) / (2.0 * a) : sigma * sigma * dt;
+    double dx = std::sqrt(3.0 * V);
+    int jmax = M < 0 ? (int)std::ceil(0.184 / -M) : N;
+    jmax = std::clamp(jmax, 1, N);
+    lat->jmax = jmax;
+
+    int width = 2 * jmax + 1;
+    lat->pu.resize(width);
+    lat->pm.resize(width);
+    lat->pd.resize(width);
+    lat->centre.resize(width);
+    for (int j = -jmax; j <= jmax; j++) {
+        double jM = j * M, j2M2 = jM * jM;
+        int i = j + jmax;
+        if (j == jmax) {            // branch down: j, j-1, j-2
+            lat->pu[i] = 7.0/6.0 + (j2M2 + 3.0*jM) / 2.0;
+            lat->pm[i] = -1.0/3.0 - j2M2 - 2.0*jM;
+            lat->pd[i] = 1.0/6.0 + (j2M2 + jM) / 2.0;
+            lat->centre[i] = j - 1;
+        } else if (j == -jmax) {    // branch up: j+2, j+1, j
+            lat->pu[i] = 1.0/6.0 + (j2M2 - jM) / 2.0;
+            lat->pm[i] = -1.0/3.0 - j2M2 + 2.0*jM;
+            lat->pd[i] = 7.0/6.0 + (j2M2 - 3.0*jM) / 2.0;
+            lat->centre[i] = j + 1;
+        } else {
+            lat->pu[i] = 1.0/6.0 + (j2M2 + jM) / 2.0;
+            lat->pm[i] = 2.0/3.0 - j2M2;
+            lat->pd[i] = 1.0/6.0 + (j2M2 - jM) / 2.0;
+            lat->centre[i] = j;
+        }
+    }
+
+    // Forward induction on Arrow-Debreu prices fits the level shift alpha_m
+    // so the tree reprices the curve's discount factors exactly.
+    lat->disc.assign((size_t)N * width, 0.0);
+    std::vector<double> Q(width, 0.0), Qnext(width, 0.0);
+    Q[jmax] = 1.0;
+    for (int m = 0; m < N; m++) {
+        int w = lat->widthAt(m);
+        double sum = 0.0;
+        for (int j = -w; j <= w; j++) sum += Q[j + jmax] * std::exp(-j * dx * dt);
+        double alpha = (std::log(sum) - std::log(curve.discount((m + 1) * dt))) / dt;
+
+        double* row = &lat->disc[(size_t)m * width];
+        std::fill(Qnext.begin(), Qnext.end(), 0.0);
+        for (int j = -w; j <= w; j++) {
+            int i = j + jmax;
+            row[i] = std::exp(-(alpha + j * dx) * dt);
+            double q = Q[i] * row[i];
+            int k = lat->centre[i] + jmax;
+            Qnext[k + 1] += q * lat->pu[i];
+            Qnext[k] += q * lat->pm[i];
+            Qnext[k - 1] += q * lat->pd[i];
+        }
+        Q.swap(Qnext);
+    }
+    return lat;
+}
+
+double HullWhiteLattice::price(const CallableBond& bond, double spread) const {
+    int nT = (int)std::lround(bond.T / step);
+    if (nT < 1 || nT > nSteps || bond.freq <= 0) return std::numeric_limits<double>::quiet_NaN();
+
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> cash(nT + 1, 0.0), callAt(nT + 1, inf), putAt(nT + 1, -inf);
+    // Coupon dates count back from maturity, matching the instrument walk.
+    for (int k = 0; bond.T - (double)k / bond.freq > 1e-9; k++) {
+        int s = std::max(1, (int)std::lround((bond.T - (double)k / bond.freq) / step));
+        cash[std::min(nT, s)] += bond.FV * bond.c / bond.freq;
+    }
+    cash[nT] += bond.FV;
+    for (const auto& e : bond.calls) {
+        int s = (int)std::lround(e.time / step);
+        if (s >= 0 && s < nT) callAt[s] = std::min(callAt[s], e.price);
+    }
+    for (const auto& e : bond.puts) {
+        int s = (int)std::lround(e.time / step);
+        if (s >= 0 && s < nT) putAt[s] = std::max(putAt[s], e.price);
+    }
+
+    int width = 2 * jmax + 1;
+    std::vector<double> V(width, 0.0), Vprev(width, 0.0);
+    int w = widthAt(nT);
+    for (int j = -w; j <= w; j++) V[j + jmax] = cash[nT];
+
+    double spreadDisc = std::exp(-spread * step);
+    const double* u = pu.data();
+    const double* md = pm.data();
+    const double* d = pd.data();
+    const int* ctr = centre.data();
+    for (int m = nT - 1; m >= 0; m--) {
+        w = widthAt(m);
+        const double* row = &disc[(size_t)m * width];
+        double callPx = callAt[m], putPx = putAt[m], cf = cash[m];
+        for (int i = jmax - w; i <= jmax + w; i++) {
+            int k = ctr[i] + jmax;
+            double cont = (u[i] * V[k + 1] + md[i] * V[k] + d[i] * V[k - 1]) * row[i] * spreadDisc;
+            cont = std::min(cont, callPx);
+            cont = std::max(cont, putPx);
+            Vprev[i] = cont + cf;
+        }
+        V.swap(Vprev);
+    }
+    return V[jmax];
+}
+
+void HullWhiteLattice::priceBatch(const std::vector<CallableBond>& bonds, std::vector<double>& out,
+                                  size_t threads, double spread) const {
+    out.resize(bonds.size());
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<size_t>(1, bonds.size() / 64));
+
+    auto work = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) out[i] = price(bonds[i], spread);
+    };
+    if (threads <= 1) {
+        work(0, bonds.size());
+        return;
+    }
+    std::vector<std::thread> pool;
+    size_t chunk = (bonds.size() + threads - 1) / threads;
+    for (size_t t = 0; t < threads; t++) {
+        size_t begin = t * chunk, end = std::min(bonds.size(), begin + chunk);
+        if (begin < end) pool.emplace_back(work, begin, end);
+    }
+    for (auto& t : pool) t.join();
+}
+
+LatticeCache::LatticeCache(size_t capacity) : capacity(std::max<size_t>(1, capacity)) {}
+
+std::shared_ptr<const HullWhiteLattice> LatticeCache::get(const YieldCurve& curve, double meanReversion,
+                                                          double sigma, double horizon, int stepsPerYear) {
+    Key key{curve.version(), meanReversion, sigma, horizon, stepsPerYear};
+    std::lock_guard<std::mutex> lock(mtx);
+    auto it = lattices.find(key);
+    if (it != lattices.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->second;
+    }
+    auto lat = HullWhiteLattice::build(curve, meanReversion, sigma, horizon, stepsPerYear);
+    lru.emplace_front(key, lat);
+    lattices.emplace(key, lru.begin());
+    if (lru.size() > capacity) {
+        lattices.erase(lru.back().first);
+        lru.pop_back();
+    }
+    return lat;
+}
+
+void LatticeCache::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    lattices.clear();
+    lru.clear();
+}
+
+size_t LatticeCache::size() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return lru.size();
+}
+
+}
@@ -0,0 +1,122 @@
+#include "load_gen.h"
+#include "bond.h"
+#include "yield_inverter.h"
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <algorithm>
+
+using namespace std;
+
+static int64_t steadyNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SyntheticFeed::SyntheticFeed(const FeedConfig& config) : cfg(config), rng(config.seed) {
+    static const int tenors[] = {2, 3, 5, 7, 10, 20, 30};
+    uniform_int_distribution<int> tenor(0, 6);
+    uniform_int_distribution<int> eighths(8, 56);
+    normal_distribution<double> spread(0.0, 0.01);
+    bernoulli_distribution annual(0.2);
+
+    bonds.reserve(cfg.universe);
+    for (size_t i = 0; i < cfg.universe; i++) {
+        SyntheticBond b;
+        b.FV = 100.0;
+        b.c = eighths(rng) / 800.0;
+        b.T = tenors[tenor(rng)];
+        b.freq = annual(rng) ? 1 : 2;
+        b.yield = clamp(b.c + spread(rng), 0.001, 0.15);
+        bonds.push_back(b);
+    }
+}
+
+Tick SyntheticFeed::next(int64_t publishNs) {
+    uniform_int_distribution<size_t> pick(0, bonds.size() - 1);
+    normal_distribution<double> shock(0.0, cfg.yieldVol);
+    size_t i = pick(rng);
+    SyntheticBond& b = bonds[i];
+    b.yield = clamp(b.yield + shock(rng), 0.0005, 0.195);
+    double price = Bonds::c_Bond(b.FV, b.c, b.yield, b.T, b.freq).price_at(b.yield);
+    return {(uint32_t)i, price, publishNs};
+}
+
+LoadTestReport runLoadTest(const LoadTestConfig& config) {
+    SyntheticFeed feed(config.feed);
+
+    vector<Bonds::YieldInverter> inverters;
+    inverters.reserve(feed.universe().size());
+    for (const auto& b : feed.universe())
+        inverters.emplace_back(Bonds::c_Bond(b.FV, b.c, b.yield, b.T, b.freq));
+
+    const size_t capacity = 65536;
+    mutex mtx;
+    condition_variable notEmpty, notFull;
+    deque<Tick> queue;
+    bool done = false;
+
+    size_t workers = max<size_t>(1, config.workers);
+    vector<vector<double>> latencies(workers);
+    vector<thread> pool;
+    for (size_t w = 0; w < workers; w++) {
+        pool.emplace_back([&, w] {
+            vector<Tick> batch;
+            auto& lat = latencies[w];
+            while (true) {
+                {
+                    unique_lock<mutex> lock(mtx);
+                    notEmpty.wait(lock, [&] { return !queue.empty() || done; });
+                    if (queue.empty()) return;
+                    size_t n = min<size_t>(queue.size(), 64);
+                    batch.assign(queue.begin(), queue.begin() + n);
+                    queue.erase(queue.begin(), queue.begin() + n);
+                }
+                notFull.notify_one();
+                for (const Tick& t : batch) {
+                    const auto& inv = inverters[t.instrument];
+                    const Bonds::c_Bond& terms = inv.bond();
+                    double y = inv.ytm(t.price);
+                    Bonds::c_Bond atMarket(terms.face_value(), terms.coupon_rate(), y, terms.maturity(), terms.frequency());
+                    volatile double risk = atMarket.modified_duration() + atMarket.convexity();
+                    (void)risk;
+                    lat.push_back((steadyNs() - t.publishNs) / 1000.0);
+                }
+            }
+        });
+    }
+
+    double rate = config.feed.tickRate;
+    int64_t start = steadyNs();
+    int64_t end = start + (int64_t)(config.durationSec * 1e9);
+    uint64_t ticks = 0;
+    while (true) {
+        int64_t publish = rate > 0 ? start + (int64_t)(ticks * 1e9 / rate) : steadyNs();
+        if (publish >= end) break;
+        if (rate > 0) this_thread::sleep_until(chrono::steady_clock::time_point(chrono::nanoseconds(publish)));
+        Tick t = feed.next(publish);
+        {
+            unique_lock<mutex> lock(mtx);
+            notFull.wait(lock, [&] { return queue.size() < capacity; });
+            queue.push_back(t);
+        }
+        notEmpty.notify_one();
+        ticks++;
+    }
+    {
+        lock_guard<mutex> lock(mtx);
+        done = true;
+    }
+    notEmpty.notify_all();
+    for (auto& t : pool) t.join();
+    double seconds = (steadyNs() - start) / 1e9;
+
+    vector<double> all;
+    for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+    sort(all.begin(), all.end());
+    auto pct = [&](double q) { return all.empty() ? 0.0 : all[min(all.size() - 1, (size_t)(q * all.size()))]; };
+
+    return {ticks, seconds, ticks / seconds, pct(0.50), pct(0.90), pct(0.99), pct(0.999), all.empty() ? 0.0 : all.back()};
+}
@@ -9,20 +9,32 @@
 #include <ctime>
 #include <chrono>
 #include <vector>
+#include <sstream>
 #include "bond.h"
 #include "db.h"
 #include "market_data.h"
+#include "fx.h"
+#include "pricing_server.h"
+#include "pricing_cache.h"
+#include "trace.h"
+#include "load_gen.h"
+#include "spread_solver.h"
+#include "reval_coordinator.h"
+#include <random>
+#include <csignal>
+#include <pthread.h>
 
 using namespace Bonds;
 
 bool isRunning = true;
 
-std::map<std::string, double> fxRates = {
-    {"USD", 1.0},
+FxService fx("USD", {
     {"EUR", 0.92},
     {"GBP", 0.78},
     {"JPY", 145.0}
-};
+});
+
+PricingCache pricingCache(1024);
 
 void line() { std::cout << "=============================================\n"; }
 
@@ -49,7 +61,7 @@ std::string getCurrency() {
     std::string currency;
     std::cout << "[INPUT] Currency (USD/EUR/GBP/JPY): ";
     std::cin >> currency;
-    if (fxRates.find(currency) == fxRates.end()) return "USD";
+    if (fx.snapshot()->index(currency) < 0) return "USD";
     return currency;
 }
 
@@ -59,9 +71,11 @@ bool askYesNo(const std::string& prompt) {
     return ch == 'y' || ch == 'Y';
 }
 
+std::mt19937_64 marketRng;     // seeded in main()
+
 double fetchMarketPrice(double modelPrice) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(300));
-    return modelPrice * (0.95 + 0.1 * (rand() / double(RAND_MAX)));
+    std::uniform_real_distribution<double> noise(0.95, 1.05);
+    return modelPrice * noise(marketRng);
 }
 
 void displayMarketDataMenu() {
@@ -97,12 +111,13 @@ void displayStockData(const std::map<std::string, double>& data, const std::stri
         return;
     }
     
+    double fxRate = fx.snapshot()->rate("USD", currency);
     printHeader("Live Stock Data - " + symbol);
     std::cout << std::setprecision(2);
-    std::cout << "Open:      " << data.at("open") * fxRates[currency] << " " << currency << "\n";
-    std::cout << "High:      " << data.at("high") * fxRates[currency] << " " << currency << "\n";
-    std::cout << "Low:       " << data.at("low") * fxRates[currency] << " " << currency << "\n";
-    std::cout << "Close:     " << data.at("close") * fxRates[currency] << " " << currency << "\n";
+    std::cout << "Open:      " << data.at("open") * fxRate << " " << currency << "\n";
+    std::cout << "High:      " << data.at("high") * fxRate << " " << currency << "\n";
+    std::cout << "Low:       " << data.at("low") * fxRate << " " << currency << "\n";
+    std::cout << "Close:     " << data.at("close") * fxRate << " " << currency << "\n";
     std::cout << "Volume:    " << data.at("volume") << " shares\n";
     std::cout << "Fetch Time:" << data.at("fetch_time") << " seconds\n";
     line();
@@ -120,11 +135,12 @@ void displayBondData(const std::map<std::string, double>& data, const std::strin
         return;
     }
     
+    double fxRate = fx.snapshot()->rate("USD", currency);
     printHeader("Live Bond Data - " + symbol);
     std::cout << std::setprecision(2);
-    std::cout << "Price:           " << data.at("price") * fxRates[currency] << " " << currency << "\n";
+    std::cout << "Price:           " << data.at("price") * fxRate << " " << currency << "\n";
     std::cout << "Volume:          " << data.at("volume") << "\n";
-    std::cout << "Change:          " << data.at("change") * fxRates[currency] << " " << currency << "\n";
+    std::cout << "Change:          " << data.at("change") * fxRate << " " << currency << "\n";
     std::cout << "Change %:        " << data.at("change_percent") << " %\n";
     std::cout << "Fetch Time:      " << data.at("fetch_time") << " seconds\n";
     line();
@@ -148,6 +164,7 @@ void fetchAndAnalyzeSecurity() {
     }
     
     if (result.success) {
+        double fxRate = fx.snapshot()->rate("USD", currency);
         printHeader("Live Market Data - " + symbol);
         std::time_t timestamp = std::chrono::system_clock::to_time_t(result.timestamp);
         std::cout << "[TIME] " << std::ctime(&timestamp);
@@ -156,7 +173,7 @@ void fetchAndAnalyzeSecurity() {
         for (const auto& [key, value] : result.data) {
             std::cout << key << ": " << value;
             if (key.find("price") != std::string::npos || key.find("close") != std::string::npos) {
-                std::cout << " " << currency << " (FX: " << value * fxRates[currency] << " " << currency << ")";
+                std::cout << " " << currency << " (FX: " << value * fxRate << " " << currency << ")";
             }
             std::cout << "\n";
         }
@@ -252,13 +269,242 @@ void compareMultipleSecurities() {
     }
 }
 
-int main(int, char**) {
-    std::srand(std::time(nullptr));
+// --serve takes a Unix socket path, host:port or a bare port.
+int runServer(const std::string& endpoint) {
+    ServerConfig cfg;
+    auto colon = endpoint.rfind(':');
+    if (endpoint.find('/') != std::string::npos) {
+        cfg.unixPath = endpoint;
+    } else if (colon != std::string::npos) {
+        cfg.host = endpoint.substr(0, colon);
+        cfg.port = std::atoi(endpoint.c_str() + colon + 1);
+    } else if (!endpoint.empty()) {
+        cfg.port = std::atoi(endpoint.c_str());
+    }
+
+    // SIGINT/SIGTERM are taken synchronously by a helper thread so stop() runs outside a signal handler.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    PricingServer server(cfg);
+    if (!server.listen()) {
+        pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+        std::cout << "[ERROR] " << server.error() << "\n";
+        return 1;
+    }
+    std::cout << "[INFO] Pricing server listening on "
+              << (cfg.unixPath.empty() ? cfg.host + ":" + std::to_string(cfg.port) : cfg.unixPath) << "\n";
+
+    // Joined before server goes out of scope; once run() returns the thread is
+    // woken with a signal of its own so it never outlives the server.
+    std::thread signalWaiter([&] {
+        int sig;
+        sigwait(&signals, &sig);
+        server.stop();
+    });
+    server.run();
+    pthread_kill(signalWaiter.native_handle(), SIGTERM);
+    signalWaiter.join();
+    pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+    std::cout << "[INFO] Pricing server stopped\n";
+    return 0;
+}
+
+std::string tracePath;
+
+void writeTrace() {
+    if (Trace::dump(tracePath)) std::cout << "[INFO] Trace written to " << tracePath << "\n";
+    else std::cout << "[ERROR] Could not write trace to " << tracePath << "\n";
+}
+
+// --loadtest [--universe N] [--rate TICKS_PER_SEC] [--duration SEC] [--workers N] [--seed N]
+int runLoadTest(int argc, char** argv) {
+    LoadTestConfig cfg;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--universe") cfg.feed.universe = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--rate") cfg.feed.tickRate = std::atof(argv[++i]);
+        else if (arg == "--duration") cfg.durationSec = std::atof(argv[++i]);
+        else if (arg == "--workers") cfg.workers = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--seed") cfg.feed.seed = std::strtoull(argv[++i], nullptr, 10);
+    }
+    if (cfg.feed.universe == 0) cfg.feed.universe = 1;
+
+    printHeader("Synthetic Load Test");
+    std::cout << "Universe            : " << cfg.feed.universe << " bonds\n";
+    std::cout << "Tick rate           : " << (cfg.feed.tickRate > 0 ? std::to_string((long)cfg.feed.tickRate) + " /s" : "unthrottled") << "\n";
+    std::cout << "Duration            : " << cfg.durationSec << " s\n";
+    std::cout << "Workers             : " << cfg.workers << "\n";
+    std::cout << "Seed                : " << cfg.feed.seed << "\n";
+
+    LoadTestReport rep = runLoadTest(cfg);
+    line();
+    std::cout << "Ticks priced        : " << rep.ticks << "\n";
+    std::cout << "Throughput          : " << rep.throughput << " ticks/s\n";
+    std::cout << "Latency p50         : " << rep.p50Us << " us\n";
+    std::cout << "Latency p90         : " << rep.p90Us << " us\n";
+    std::cout << "Latency p99         : " << rep.p99Us << " us\n";
+    std::cout << "Latency p99.9       : " << rep.p999Us << " us\n";
+    std::cout << "Latency max         : " << rep.maxUs << " us\n";
+    line();
+    return 0;
+}
+
+// --reval [--workers N | --connect EP1,EP2,...] [--snapshot FILE] [--timeout MS]
+// Revalues bonds.db (or a CSV snapshot) across N local workers or running --serve endpoints.
+int runReval(int argc, char** argv) {
+    RevalConfig cfg;
+    std::string snapshot;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--workers") cfg.spawn = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--timeout") cfg.timeoutMs = std::atoi(argv[++i]);
+        else if (arg == "--snapshot") snapshot = argv[++i];
+        else if (arg == "--connect") {
+            std::stringstream ss(argv[++i]);
+            std::string ep;
+            while (std::getline(ss, ep, ',')) if (!ep.empty()) cfg.endpoints.push_back(ep);
+        }
+    }
+
+    std::vector<RevalPosition> book;
+    size_t skipped = 0;
+    if (snapshot.empty()) {
+        BondDB db("bonds.db");
+        db.init();
+        book = RevalCoordinator::fromRecords(db.loadBonds(), &skipped);
+    } else {
+        std::string error;
+        if (!RevalCoordinator::loadSnapshot(snapshot, book, error, &skipped)) {
+            std::cout << "[ERROR] " << error << "\n";
+            return 1;
+        }
+    }
+
+    RevalCoordinator coordinator(cfg);
+    RevalReport rep = coordinator.run(book);
+    if (!rep.success) {
+        std::cout << "[ERROR] " << rep.error_message << "\n";
+        return 1;
+    }
+    printHeader("Sharded Revaluation");
+    std::cout << std::setprecision(4);
+    for (size_t k = 0; k < rep.shards.size(); k++) {
+        const ShardTotal& s = rep.shards[k];
+        std::cout << "Shard " << std::setw(3) << k << "  bonds " << std::setw(8) << s.count
+                  << "  PV " << std::setw(16) << s.pv << "  DV01 " << std::setw(12) << s.dv01
+                  << (s.attempts > 1 ? "  (restarted)" : "") << "\n";
+    }
+    line();
+    std::cout << "Positions           : " << rep.positions << "\n";
+    if (skipped) std::cout << "Skipped on load     : " << skipped << "\n";
+    std::cout << "Priced              : " << rep.total.count << " (" << rep.total.errors << " rejected)\n";
+    std::cout << "Total PV            : " << rep.total.pv << "\n";
+    std::cout << "Total DV01          : " << rep.total.dv01 << "\n";
+    std::cout << "Dollar Convexity    : " << rep.total.convexity << "\n";
+    std::cout << "Elapsed             : " << rep.seconds << " s\n";
+    line();
+    return 0;
+}
+
+// Saved bonds with their value in the currency each was saved in, and the
+// book total in USD. Every figure comes from one FX snapshot.
+void printPortfolio(BondDB& db) {
+    auto bonds = db.loadBonds();
+    printHeader("All Bonds in Database");
+    if (bonds.empty()) {
+        std::cout << "No bonds in database.\n";
+        line();
+        return;
+    }
+    std::cout << std::setprecision(2);
+    auto snap = fx.snapshot();
+    int usd = snap->index("USD");
+    FxPositions positions;
+    for (const auto& b : bonds) {
+        int ccy = snap->index(b.currency);
+        if (ccy < 0) ccy = usd;
+        double value = b.price * snap->rate(usd, ccy);
+        positions.add(ccy, value);
+        std::cout << "- " << b.name << "  " << value << " " << snap->currencies[ccy] << "\n";
+    }
+    std::cout << "Total: " << FxService::total(*snap, positions, usd) << " USD\n";
+    line();
+}
+
+// --fx EUR=0.93,GBP=0.79 overrides the built-in rates (units per USD).
+bool parseFxRates(const std::string& spec, std::map<std::string, double>& out) {
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos || eq == 0) return false;
+        char* end = nullptr;
+        double rate = std::strtod(item.c_str() + eq + 1, &end);
+        if (end == item.c_str() + eq + 1 || *end || !(rate > 0)) return false;
+        out[item.substr(0, eq)] = rate;
+    }
+    return !out.empty();
+}
+
+// --sql "SELECT ..." runs one query against bonds.db, with the bond_* functions registered.
+int runQuery(const std::string& sql) {
+    BondDB db("bonds.db");
+    db.init();
+    QueryResult res = db.query(sql);
+    if (!res.success) {
+        std::cout << "[ERROR] " << res.error_message << "\n";
+        return 1;
+    }
+    if (res.columns.empty()) return 0;
+    for (size_t i = 0; i < res.columns.size(); i++) std::cout << (i ? "\t" : "") << res.columns[i];
+    std::cout << "\n";
+    for (const auto& row : res.rows) {
+        for (size_t i = 0; i < row.size(); i++) std::cout << (i ? "\t" : "") << row[i];
+        std::cout << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // --profile [file] records a Chrome/Perfetto trace of the session, written on exit.
+    // --seed N fixes the simulated and mock market data; otherwise they vary per run.
+    // --fx CCY=rate,... replaces the quoted FX rates before anything is priced.
+    uint64_t seed = (uint64_t)std::time(nullptr);
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--profile") {
+            tracePath = i + 1 < argc && argv[i + 1][0] != '-' ? argv[++i] : "trace.json";
+            Trace::start();
+            std::atexit(writeTrace);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (arg == "--fx" && i + 1 < argc) {
+            std::map<std::string, double> rates;
+            if (parseFxRates(argv[++i], rates)) fx.update(rates);
+            else std::cout << "[ERROR] Ignoring malformed --fx rates: " << argv[i] << "\n";
+        }
+    }
+    marketRng.seed(seed);
+    MarketData::setMockSeed(seed);
+
     std::cout.setf(std::ios::fixed);
     std::cout << std::setprecision(2);
 
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--serve") return runServer(i + 1 < argc ? argv[i + 1] : "");
+        if (arg == "--loadtest") return runLoadTest(argc, argv);
+        if (arg == "--sql" && i + 1 < argc) return runQuery(argv[i + 1]);
+        if (arg == "--reval") return runReval(argc, argv);
+    }
+
     BondDB db("bonds.db");
     db.init();
+    db.enableWriteBehind();
 
     while (isRunning) {
         printMenu();
@@ -278,9 +524,11 @@ int main(int, char**) {
 
             if (FV <= 0 || r < 0 || T <= 0) continue;
 
+            double fxRate = fx.snapshot()->rate("USD", cur);
             zc_Bond zc(FV, r/100.0, T);
-            double priceUSD = zc.price();
-            double priceCur = priceUSD * fxRates[cur];
+            PricingResult res = pricingCache.get(PricingKey::zeroCoupon(FV, r/100.0, T));
+            double priceUSD = res.price;
+            double priceCur = priceUSD * fxRate;
 
             printHeader("Zero-Coupon Bond — Results");
             std::cout << std::setprecision(4);
@@ -290,17 +538,18 @@ int main(int, char**) {
             std::cout << "Maturity            : " << T  << " years\n";
             std::cout << "Price               : " << std::setprecision(2) << priceCur << " " << cur << "\n";
             std::cout << std::setprecision(6);
-            std::cout << "Macaulay Duration   : " << zc.macaulay_duration() << " years\n";
-            std::cout << "Modified Duration   : " << zc.modified_duration() << " years\n";
-            std::cout << "Convexity           : " << zc.convexity() << " years^2\n\n";
+            std::cout << "Macaulay Duration   : " << res.macaulay_duration << " years\n";
+            std::cout << "Modified Duration   : " << res.modified_duration << " years\n";
+            std::cout << "Convexity           : " << res.convexity << " years^2\n\n";
 
             if (askYesNo("Save bond to DB?")) {
-                db.saveBond(bondName, "Zero-Coupon", FV, 0.0, r/100.0, T, 1, priceUSD, cur);
+                if (!db.saveBond(bondName, "Zero-Coupon", FV, 0.0, r/100.0, T, 1, priceUSD, cur))
+                    std::cout << "[ERROR] Could not save bond: " << db.lastError() << "\n";
             }
 
             if (askYesNo("Fetch simulated market price?")) {
                 double mktPrice = fetchMarketPrice(priceUSD);
-                double mktCur = mktPrice * fxRates[cur];
+                double mktCur = mktPrice * fxRate;
                 std::cout << "\033[32m[MARKET] Price: " << std::setprecision(2) << mktCur << " " << cur << "\033[0m\n";
                 double y = zc.ytm(mktPrice);
                 if (std::isfinite(y)) std::cout << "[MARKET] Implied YTM: " << y*100 << " %\n\n";
@@ -316,8 +565,8 @@ int main(int, char**) {
                     double marketPrice = marketResult.data["price"];
                     MarketData::compareWithCalculatedPrice(marketPrice, priceUSD, marketSymbol);
                     MarketData::analyzePriceDiscrepancy(marketPrice, priceUSD,
-                                                      zc.modified_duration(),
-                                                      zc.convexity(),
+                                                      res.modified_duration,
+                                                      res.convexity,
                                                       zc.ytm(marketPrice));
                 }
             }
@@ -337,9 +586,11 @@ int main(int, char**) {
 
             if (FV <= 0 || c < 0 || r < 0 || T <= 0 || freq <= 0) continue;
 
+            double fxRate = fx.snapshot()->rate("USD", cur);
             c_Bond bond(FV, c/100.0, r/100.0, T, freq);
-            double priceUSD = bond.price();
-            double priceCur = priceUSD * fxRates[cur];
+            PricingResult res = pricingCache.get(PricingKey::couponBond(FV, c/100.0, r/100.0, T, freq));
+            double priceUSD = res.price;
+            double priceCur = priceUSD * fxRate;
 
             printHeader("Coupon Bond — Results");
             std::cout << std::setprecision(4);
@@ -352,17 +603,18 @@ int main(int, char**) {
             std::cout << "Price               : " << std::setprecision(2) << priceCur << " " << cur << "\n";
             std::cout << std::setprecision(6);
             std::cout << "Current Yield       : " << bond.current_yield(priceUSD)*100.0 << " %\n";
-            std::cout << "Macaulay Duration   : " << bond.macaulay_duration() << " years\n";
-            std::cout << "Modified Duration   : " << bond.modified_duration() << " years\n";
-            std::cout << "Convexity           : " << bond.convexity() << " years^2\n\n";
+            std::cout << "Macaulay Duration   : " << res.macaulay_duration << " years\n";
+            std::cout << "Modified Duration   : " << res.modified_duration << " years\n";
+            std::cout << "Convexity           : " << res.convexity << " years^2\n\n";
 
             if (askYesNo("Save bond to DB?")) {
-                db.saveBond(bondName, "Coupon", FV, c/100.0, r/100.0, T, freq, priceUSD, cur);
+                if (!db.saveBond(bondName, "Coupon", FV, c/100.0, r/100.0, T, freq, priceUSD, cur))
+                    std::cout << "[ERROR] Could not save bond: " << db.lastError() << "\n";
             }
 
             if (askYesNo("Fetch simulated market price?")) {
                 double mktPrice = fetchMarketPrice(priceUSD);
-                double mktCur = mktPrice * fxRates[cur];
+                double mktCur = mktPrice * fxRate;
                 std::cout << "\033[32m[MARKET] Price: " << std::setprecision(2) << mktCur << " " << cur << "\033[0m\n";
                 double y = bond.ytm(mktPrice);
                 if (std::isfinite(y)) std::cout << "[MARKET] Implied YTM: " << y*100 << " %\n\n";
@@ -378,9 +630,17 @@ int main(int, char**) {
                     double marketPrice = marketResult.data["price"];
                     MarketData::compareWithCalculatedPrice(marketPrice, priceUSD, marketSymbol);
                     MarketData::analyzePriceDiscrepancy(marketPrice, priceUSD,
-                                                      bond.modified_duration(),
-                                                      bond.convexity(),
+                                                      res.modified_duration,
+                                                      res.convexity,
                                                       bond.ytm(marketPrice));
+
+                    // Model curve: flat at the discount rate, continuously compounded.
+                    YieldCurve model = YieldCurve::flat(freq * std::log1p(r / 100.0 / freq));
+                    SpreadSolver solver;
+                    std::vector<SpreadResult> spread;
+                    solver.zSpreads({FixedBullet{FV, c/100.0, (double)T, freq}}, {marketPrice}, model, spread);
+                    if (spread[0].converged)
+                        std::cout << "Z-Spread vs Model Curve: " << std::setprecision(2) << spread[0].spread * 1e4 << " bp\n";
                 }
             }
         }
@@ -401,16 +661,7 @@ int main(int, char**) {
             line();
         }
         else if (choice == 4) {
-            auto results = db.listBonds();
-            printHeader("All Bonds in Database");
-            if (results.empty()) {
-                std::cout << "No bonds in database.\n";
-            } else {
-                for (const auto& bond : results) {
-                    std::cout << "- " << bond << "\n";
-                }
-            }
-            line();
+            printPortfolio(db);
         }
         else if (choice == 5) {
             bool marketMenuRunning = true;
@@ -8,7 +8,13 @@
 #include <cmath>
 #include <algorithm>
 #include <numeric>
+#include <fstream>
+#include <mutex>
+#include <memory>
+#include <cctype>
+#include <random>
 #include <json/json.h>
+#include "trace.h"
 
 using namespace std;
 
@@ -30,197 +36,327 @@ double MarketData::safeStod(const string& str) {
     }
 }
 
-MarketDataResult MarketData::fetchStockData(const string& symbol) {
-    MarketDataResult result;
-    result.symbol = symbol;
-    result.type = "STOCK";
-    result.timestamp = chrono::system_clock::now();
-    
-    auto start = chrono::high_resolution_clock::now();
-    
-    string command = "python3 fetch_market_data.py STOCK " + symbol + " 2>&1";
-    FILE* pipe = popen(command.c_str(), "r");
-    if (!pipe) {
-        result.success = false;
-        result.error_message = "Failed to execute Python script";
-        return result;
+namespace {
+
+mutex configMutex;
+HttpClientConfig httpConfig;
+shared_ptr<HttpClient> httpClient;
+string alphaApiKey;
+bool alphaApiKeyLoaded = false;
+
+mutex mockMutex;
+mt19937_64 mockRng(42);
+
+int mockRand() {
+    lock_guard<mutex> lock(mockMutex);
+    return (int)(mockRng() >> 33);
+}
+
+map<string, string> loadEnvFile() {
+    map<string, string> vars;
+    ifstream in(".env");
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        auto eq = line.find('=');
+        if (eq == string::npos) continue;
+        string value = line.substr(eq + 1);
+        while (!value.empty() && isspace((unsigned char)value.back())) value.pop_back();
+        vars[line.substr(0, eq)] = value;
     }
-    
-    char buffer[4096];
-    string output;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
+    return vars;
+}
+
+string envOrDotEnv(const char* name) {
+    if (const char* v = getenv(name)) return v;
+    auto vars = loadEnvFile();
+    auto it = vars.find(name);
+    return it == vars.end() ? "" : it->second;
+}
+
+}
+
+void MarketData::configure(const HttpClientConfig& config) {
+    lock_guard<mutex> lock(configMutex);
+    httpConfig = config;
+    httpClient.reset();
+}
+
+void MarketData::setMockSeed(uint64_t seed) {
+    lock_guard<mutex> lock(mockMutex);
+    mockRng.seed(seed);
+}
+
+void MarketData::setApiKey(const string& key) {
+    lock_guard<mutex> lock(configMutex);
+    alphaApiKey = key;
+    alphaApiKeyLoaded = true;
+}
+
+shared_ptr<HttpClient> MarketData::client() {
+    lock_guard<mutex> lock(configMutex);
+    if (!httpClient) {
+        HttpClientConfig cfg = httpConfig;
+        string baseUrl = envOrDotEnv("ALPHA_BASE_URL");
+        if (!baseUrl.empty()) cfg.baseUrl = baseUrl;
+        httpClient = make_shared<HttpClient>(cfg);
     }
-    pclose(pipe);
-    
-    auto end = chrono::high_resolution_clock::now();
-    result.fetch_time_ms = chrono::duration_cast<chrono::milliseconds>(end - start).count();
-    
-    Json::Value root;
-    Json::CharReaderBuilder reader;
-    stringstream ss(output);
-    string errs;
-    
-    if (Json::parseFromStream(reader, ss, &root, &errs)) {
-        if (root.isMember("error")) {
-            result.success = false;
-            result.error_message = root["error"].asString();
-        } else if (root.isMember("data")) {
-            Json::Value data = root["data"];
-            result.success = true;
+    return httpClient;
+}
+
+string MarketData::apiKey() {
+    lock_guard<mutex> lock(configMutex);
+    if (!alphaApiKeyLoaded) {
+        alphaApiKey = envOrDotEnv("ALPHA_API_KEY");
+        alphaApiKeyLoaded = true;
+    }
+    return alphaApiKey;
+}
+
+string MarketData::stockPath(const string& symbol) {
+    return "/query?function=TIME_SERIES_DAILY&symbol=" + HttpClient::urlEncode(symbol) +
+           "&apikey=" + HttpClient::urlEncode(apiKey());
+}
+
+string MarketData::bondPath(const string& symbol) {
+    return "/query?function=GLOBAL_QUOTE&symbol=" + HttpClient::urlEncode(symbol) +
+           "&apikey=" + HttpClient::urlEncode(apiKey());
+}
+
+void MarketData::parseStockSeries(const Json::Value& data, MarketDataResult& result) {
+    if (data.isMember("Time Series (Daily)")) {
+        Json::Value timeSeries = data["Time Series (Daily)"];
+        if (!timeSeries.empty()) {
+            auto dates = timeSeries.getMemberNames();
+            sort(dates.rbegin(), dates.rend());
+            
+            vector<double> dailyCloses;
+            int daysToProcess = min(5, (int)dates.size());
             
-            if (data.isMember("Time Series (Daily)")) {
-                Json::Value timeSeries = data["Time Series (Daily)"];
-                if (!timeSeries.empty()) {
-                    auto dates = timeSeries.getMemberNames();
-                    sort(dates.rbegin(), dates.rend());
-                    
-                    vector<double> dailyCloses;
-                    int daysToProcess = min(5, (int)dates.size());
-                    
-                    for (int i = 0; i < daysToProcess; i++) {
-                        string date = dates[i];
-                        Json::Value dayData = timeSeries[date];
-                        double close = MarketData::safeStod(dayData["4. close"].asString());
-                        dailyCloses.push_back(close);
-                        result.data["close_" + to_string(i+1)] = close;
-                    }
-                    
-                    if (!dailyCloses.empty()) {
-                        result.data["price"] = dailyCloses[0];
-                        result.data["open"] = MarketData::safeStod(timeSeries[dates[0]]["1. open"].asString());
-                        result.data["high"] = MarketData::safeStod(timeSeries[dates[0]]["2. high"].asString());
-                        result.data["low"] = MarketData::safeStod(timeSeries[dates[0]]["3. low"].asString());
-                        result.data["volume"] = MarketData::safeStod(timeSeries[dates[0]]["5. volume"].asString());
-                    }
-                    
-                    if (dailyCloses.size() >= 2) {
-                        vector<double> returns;
-                        for (size_t i = 1; i < dailyCloses.size(); i++) {
-                            double ret = (dailyCloses[i] - dailyCloses[i-1]) / dailyCloses[i-1];
-                            returns.push_back(ret);
-                        }
-                        double volatility = MarketData::calculateVolatility(returns) * sqrt(252);
-                        result.data["annual_volatility"] = volatility;
-                    }
+            for (int i = 0; i < daysToProcess; i++) {
+                string date = dates[i];
+                Json::Value dayData = timeSeries[date];
+                double close = MarketData::safeStod(dayData["4. close"].asString());
+                dailyCloses.push_back(close);
+                result.data["close_" + to_string(i+1)] = close;
+            }
+            
+            if (!dailyCloses.empty()) {
+                result.data["price"] = dailyCloses[0];
+                result.data["open"] = MarketData::safeStod(timeSeries[dates[0]]["1. open"].asString());
+                result.data["high"] = MarketData::safeStod(timeSeries[dates[0]]["2. high"].asString());
+                result.data["low"] = MarketData::safeStod(timeSeries[dates[0]]["3. low"].asString());
+                result.data["volume"] = MarketData::safeStod(timeSeries[dates[0]]["5. volume"].asString());
+            }
+            
+            if (dailyCloses.size() >= 2) {
+                vector<double> returns;
+                for (size_t i = 1; i < dailyCloses.size(); i++) {
+                    double ret = (dailyCloses[i] - dailyCloses[i-1]) / dailyCloses[i-1];
+                    returns.push_back(ret);
                 }
+                double volatility = MarketData::calculateVolatility(returns) * sqrt(252);
+                result.data["annual_volatility"] = volatility;
             }
         }
-    } else {
-        result.success = false;
-        result.error_message = "JSON parse error: " + errs;
     }
+}
+
+void MarketData::parseGlobalQuote(const Json::Value& data, MarketDataResult& result) {
+    if (data.isMember("Global Quote")) {
+        Json::Value quote = data["Global Quote"];
+        result.data["price"] = MarketData::safeStod(quote["05. price"].asString());
+        result.data["change"] = MarketData::safeStod(quote["09. change"].asString());
+        
+        string changePercent = quote["10. change percent"].asString();
+        if (!changePercent.empty() && changePercent.back() == '%') {
+            changePercent.pop_back();
+        }
+        result.data["change_percent"] = MarketData::safeStod(changePercent);
+    }
+}
+
+// Decodes an Alpha Vantage response body into root. Alpha Vantage reports
+// throttling and bad symbols with HTTP 200 and a message field.
+static bool decodeResponse(const HttpResponse& response, Json::Value& root, string& error) {
+    TRACE_SCOPE("parse_json", "parse");
+    if (!response.success) {
+        error = response.error_message;
+        return false;
+    }
+    Json::CharReaderBuilder reader;
+    stringstream ss(response.body);
+    string errs;
+    if (!Json::parseFromStream(reader, ss, &root, &errs)) {
+        error = "JSON parse error: " + errs;
+        return false;
+    }
+    for (const char* key : {"Error Message", "Note", "Information"}) {
+        if (root.isMember(key)) {
+            error = root[key].asString();
+            return false;
+        }
+    }
+    return true;
+}
+
+void MarketData::applyStockMock(MarketDataResult& result) {
+    result.success = true;
+    result.data["price"] = 150.0 + (mockRand() % 50);
+    result.data["open"] = result.data["price"] - (mockRand() % 10);
+    result.data["high"] = result.data["price"] + (mockRand() % 5);
+    result.data["low"] = result.data["price"] - (mockRand() % 8);
+    result.data["volume"] = 1000000 + (mockRand() % 9000000);
+    result.data["change"] = (mockRand() % 10) - 5.0;
+    result.data["change_percent"] = (mockRand() % 500) / 100.0 - 2.5;
+    result.data["annual_volatility"] = 0.15 + (mockRand() % 200) / 1000.0;
+    result.error_message = "Using mock data (API failed: " + result.error_message + ")";
+}
+
+void MarketData::applyBondMock(MarketDataResult& result) {
+    const string& symbol = result.symbol;
+    result.success = true;
     
-    if (!result.success) {
-        result.success = true;
-        result.data["price"] = 150.0 + (rand() % 50);
-        result.data["open"] = result.data["price"] - (rand() % 10);
-        result.data["high"] = result.data["price"] + (rand() % 5);
-        result.data["low"] = result.data["price"] - (rand() % 8);
-        result.data["volume"] = 1000000 + (rand() % 9000000);
-        result.data["change"] = (rand() % 10) - 5.0;
-        result.data["change_percent"] = (rand() % 500) / 100.0 - 2.5;
-        result.data["annual_volatility"] = 0.15 + (rand() % 200) / 1000.0;
-        result.error_message = "Using mock data (API failed: " + result.error_message + ")";
+    if (symbol.find("10") != string::npos) {
+        result.data["price"] = 98.5 + (mockRand() % 30) / 10.0;
+        result.data["yield"] = 4.2 + (mockRand() % 20) / 100.0;
+    } else if (symbol.find("30") != string::npos) {
+        result.data["price"] = 101.2 + (mockRand() % 40) / 10.0;
+        result.data["yield"] = 4.5 + (mockRand() % 25) / 100.0;
+    } else if (symbol.find("2") != string::npos) {
+        result.data["price"] = 99.8 + (mockRand() % 15) / 10.0;
+        result.data["yield"] = 4.8 + (mockRand() % 15) / 100.0;
+    } else {
+        result.data["price"] = 100.0 + (mockRand() % 20) / 10.0;
+        result.data["yield"] = 4.3 + (mockRand() % 20) / 100.0;
     }
     
-    return result;
+    result.data["change"] = (mockRand() % 10) / 10.0 - 0.5;
+    result.data["change_percent"] = (mockRand() % 50) / 100.0 - 0.25;
+    result.data["volume"] = 500000 + (mockRand() % 500000);
+    result.error_message = "Using mock bond data (API failed: " + result.error_message + ")";
 }
 
-MarketDataResult MarketData::fetchBondData(const string& symbol) {
+MarketDataResult MarketData::stockFromResponse(const string& symbol, const HttpResponse& response) {
     MarketDataResult result;
     result.symbol = symbol;
-    result.type = "BOND";
+    result.type = "STOCK";
     result.timestamp = chrono::system_clock::now();
-    
-    auto start = chrono::high_resolution_clock::now();
-    
-    string command = "python3 fetch_market_data.py BOND " + symbol + " 2>&1";
-    FILE* pipe = popen(command.c_str(), "r");
-    if (!pipe) {
-        result.success = false;
-        result.error_message = "Failed to execute Python script";
-        return result;
-    }
-    
-    char buffer[4096];
-    string output;
-    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-        output += buffer;
-    }
-    pclose(pipe);
-    
-    auto end = chrono::high_resolution_clock::now();
-    result.fetch_time_ms = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    result.fetch_time_ms = response.fetch_time_ms;
+    result.success = false;
     
     Json::Value root;
-    Json::CharReaderBuilder reader;
-    stringstream ss(output);
-    string errs;
+    if (apiKey().empty()) {
+        result.error_message = "ALPHA_API_KEY not found in environment or .env";
+    } else if (decodeResponse(response, root, result.error_message)) {
+        result.success = true;
+        parseStockSeries(root, result);
+    }
     
-    if (Json::parseFromStream(reader, ss, &root, &errs)) {
-        if (root.isMember("error")) {
-            result.success = false;
-            result.error_message = root["error"].asString();
-        } else if (root.isMember("data")) {
-            Json::Value data = root["data"];
-            result.success = true;
-            
-            if (data.isMember("Global Quote")) {
-                Json::Value quote = data["Global Quote"];
-                result.data["price"] = MarketData::safeStod(quote["05. price"].asString());
-                result.data["change"] = MarketData::safeStod(quote["09. change"].asString());
-                
-                string changePercent = quote["10. change percent"].asString();
-                if (!changePercent.empty() && changePercent.back() == '%') {
-                    changePercent.pop_back();
-                }
-                result.data["change_percent"] = MarketData::safeStod(changePercent);
-            }
+    if (!result.success) applyStockMock(result);
+    result.data["fetch_time"] = result.fetch_time_ms / 1000.0;
+    return result;
+}
+
+static bool isUsTreasury(const string& symbol) {
+    return symbol.size() > 2 && toupper((unsigned char)symbol[0]) == 'U' && toupper((unsigned char)symbol[1]) == 'S';
+}
+
+// Alpha Vantage has no treasury quotes, so the common US benchmarks are served
+// from a fixed table; anything else is looked up as a listed (e.g. ETF) quote.
+bool MarketData::simulatedTreasuryQuote(const string& symbol, MarketDataResult& result) {
+    struct Quote { const char* symbol; double price, yield, change; };
+    static const Quote treasuries[] = {
+        {"US10Y", 100.25, 4.25, 0.05},
+        {"US30Y", 101.50, 4.50, -0.02},
+        {"US2Y",  99.75,  4.75, 0.01},
+        {"US5Y",  100.10, 4.35, 0.03},
+    };
+    string upper = symbol;
+    for (auto& ch : upper) ch = (char)toupper((unsigned char)ch);
+    for (const auto& q : treasuries) {
+        if (upper == q.symbol) {
+            result.data["price"] = q.price;
+            result.data["change"] = q.change;
+            result.data["change_percent"] = q.change * 100;
+            return true;
         }
-    } else {
-        result.success = false;
-        result.error_message = "JSON parse error: " + errs;
     }
+    return false;
+}
+
+MarketDataResult MarketData::bondFromResponse(const string& symbol, const HttpResponse& response) {
+    MarketDataResult result;
+    result.symbol = symbol;
+    result.type = "BOND";
+    result.timestamp = chrono::system_clock::now();
+    result.fetch_time_ms = response.fetch_time_ms;
+    result.success = false;
     
-    if (!result.success) {
+    Json::Value root;
+    if (simulatedTreasuryQuote(symbol, result)) {
         result.success = true;
-        
-        if (symbol.find("10") != string::npos) {
-            result.data["price"] = 98.5 + (rand() % 30) / 10.0;
-            result.data["yield"] = 4.2 + (rand() % 20) / 100.0;
-        } else if (symbol.find("30") != string::npos) {
-            result.data["price"] = 101.2 + (rand() % 40) / 10.0;
-            result.data["yield"] = 4.5 + (rand() % 25) / 100.0;
-        } else if (symbol.find("2") != string::npos) {
-            result.data["price"] = 99.8 + (rand() % 15) / 10.0;
-            result.data["yield"] = 4.8 + (rand() % 15) / 100.0;
-        } else {
-            result.data["price"] = 100.0 + (rand() % 20) / 10.0;
-            result.data["yield"] = 4.3 + (rand() % 20) / 100.0;
-        }
-        
-        result.data["change"] = (rand() % 10) / 10.0 - 0.5;
-        result.data["change_percent"] = (rand() % 50) / 100.0 - 0.25;
-        result.data["volume"] = 500000 + (rand() % 500000);
-        result.error_message = "Using mock bond data (API failed: " + result.error_message + ")";
+    } else if (isUsTreasury(symbol)) {
+        result.error_message = "Bond " + symbol + " not found";
+    } else if (apiKey().empty()) {
+        result.error_message = "ALPHA_API_KEY not found in environment or .env";
+    } else if (decodeResponse(response, root, result.error_message)) {
+        result.success = true;
+        parseGlobalQuote(root, result);
     }
     
+    if (!result.success) applyBondMock(result);
+    result.data["fetch_time"] = result.fetch_time_ms / 1000.0;
     return result;
 }
 
+MarketDataResult MarketData::fetchStockData(const string& symbol) {
+    TRACE_SCOPE_ARG("fetchStockData", "fetch", "symbol", symbol);
+    HttpResponse response;
+    if (!apiKey().empty()) response = client()->get(stockPath(symbol));
+    return stockFromResponse(symbol, response);
+}
+
+MarketDataResult MarketData::fetchBondData(const string& symbol) {
+    TRACE_SCOPE_ARG("fetchBondData", "fetch", "symbol", symbol);
+    HttpResponse response;
+    if (!isUsTreasury(symbol) && !apiKey().empty()) response = client()->get(bondPath(symbol));
+    return bondFromResponse(symbol, response);
+}
+
 vector<MarketDataResult> MarketData::fetchMultipleStocks(const vector<string>& symbols) {
+    TRACE_SCOPE("fetchMultipleStocks", "fetch");
+    vector<HttpResponse> responses(symbols.size());
+    if (!apiKey().empty()) {
+        vector<string> paths;
+        for (const auto& symbol : symbols) paths.push_back(stockPath(symbol));
+        responses = client()->getMany(paths);
+    }
     vector<MarketDataResult> results;
-    for (const auto& symbol : symbols) {
-        results.push_back(fetchStockData(symbol));
+    for (size_t i = 0; i < symbols.size(); i++) {
+        results.push_back(stockFromResponse(symbols[i], responses[i]));
     }
     return results;
 }
 
 vector<MarketDataResult> MarketData::fetchMultipleBonds(const vector<string>& symbols) {
+    TRACE_SCOPE("fetchMultipleBonds", "fetch");
+    vector<HttpResponse> responses(symbols.size());
+    vector<string> paths;
+    vector<size_t> listed;
+    if (!apiKey().empty()) {
+        for (size_t i = 0; i < symbols.size(); i++) {
+            if (isUsTreasury(symbols[i])) continue;
+            paths.push_back(bondPath(symbols[i]));
+            listed.push_back(i);
+        }
+    }
+    auto fetched = client()->getMany(paths);
+    for (size_t k = 0; k < listed.size(); k++) responses[listed[k]] = std::move(fetched[k]);
+    
     vector<MarketDataResult> results;
-    for (const auto& symbol : symbols) {
-        results.push_back(fetchBondData(symbol));
+    for (size_t i = 0; i < symbols.size(); i++) {
+        results.push_back(bondFromResponse(symbols[i], responses[i]));
     }
     return results;
 }
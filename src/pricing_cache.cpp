@@ -0,0 +1,120 @@
+#include "pricing_cache.h"
+#include "bond.h"
+#include "trace.h"
+#include <cstring>
+
+namespace Bonds {
+
+// Folds -0.0 into 0.0 so equal rates hash the same.
+static double canonical(double v) { return v == 0.0 ? 0.0 : v; }
+
+PricingKey PricingKey::zeroCoupon(double face_value, double rate, int maturity) {
+    return {false, canonical(face_value), 0.0, canonical(rate), maturity, 1};
+}
+
+PricingKey PricingKey::couponBond(double face_value, double coupon_rate, double discount_rate, int maturity, int frequency) {
+    return {true, canonical(face_value), canonical(coupon_rate), canonical(discount_rate), maturity, frequency};
+}
+
+bool PricingKey::operator==(const PricingKey& o) const {
+    return coupon == o.coupon && FV == o.FV && c == o.c && r == o.r && T == o.T && freq == o.freq;
+}
+
+size_t PricingKeyHash::operator()(const PricingKey& k) const {
+    auto mix = [](uint64_t h, uint64_t v) {
+        h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        return h;
+    };
+    auto bits = [](double d) { uint64_t u; std::memcpy(&u, &d, sizeof(u)); return u; };
+    uint64_t h = k.coupon ? 1 : 0;
+    h = mix(h, bits(k.FV));
+    h = mix(h, bits(k.c));
+    h = mix(h, bits(k.r));
+    h = mix(h, (uint64_t)(uint32_t)k.T << 32 | (uint32_t)k.freq);
+    return (size_t)h;
+}
+
+PricingCache::PricingCache(size_t capacity, size_t shardCount)
+    : shardCapacity(0), hits(0), misses(0), evictions(0) {
+    if (shardCount == 0) shardCount = 1;
+    for (size_t i = 0; i < shardCount; i++) shards.push_back(std::make_unique<Shard>());
+    shardCapacity = (capacity + shardCount - 1) / shardCount;
+    if (shardCapacity == 0) shardCapacity = 1;
+}
+
+PricingCache::Shard& PricingCache::shardFor(size_t hash) {
+    // The unordered_map uses the low bits; pick the shard from the high ones.
+    uint64_t h = hash;
+    return *shards[(h >> 32 ^ h >> 48) % shards.size()];
+}
+
+PricingResult PricingCache::compute(const PricingKey& k) {
+    TRACE_SCOPE("price_bond", "price");
+    if (k.coupon) {
+        c_Bond b(k.FV, k.c, k.r, k.T, k.freq);
+        return {b.price(), b.macaulay_duration(), b.modified_duration(), b.convexity()};
+    }
+    zc_Bond b(k.FV, k.r, k.T);
+    return {b.price(), b.macaulay_duration(), b.modified_duration(), b.convexity()};
+}
+
+bool PricingCache::lookup(const PricingKey& key, PricingResult& out) {
+    size_t h = PricingKeyHash()(key);
+    Shard& s = shardFor(h);
+    std::lock_guard<std::mutex> lock(s.mtx);
+    auto it = s.index.find(key);
+    if (it == s.index.end()) {
+        misses++;
+        return false;
+    }
+    s.lru.splice(s.lru.begin(), s.lru, it->second);
+    out = it->second->second;
+    hits++;
+    return true;
+}
+
+void PricingCache::insert(const PricingKey& key, const PricingResult& value) {
+    size_t h = PricingKeyHash()(key);
+    Shard& s = shardFor(h);
+    std::lock_guard<std::mutex> lock(s.mtx);
+    auto it = s.index.find(key);
+    if (it != s.index.end()) {
+        it->second->second = value;
+        s.lru.splice(s.lru.begin(), s.lru, it->second);
+        return;
+    }
+    s.lru.emplace_front(key, value);
+    s.index.emplace(key, s.lru.begin());
+    if (s.lru.size() > shardCapacity) {
+        s.index.erase(s.lru.back().first);
+        s.lru.pop_back();
+        evictions++;
+    }
+}
+
+PricingResult PricingCache::get(const PricingKey& key) {
+    PricingResult res;
+    if (lookup(key, res)) return res;
+    res = compute(key);
+    insert(key, res);
+    return res;
+}
+
+void PricingCache::clear() {
+    for (auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mtx);
+        s->lru.clear();
+        s->index.clear();
+    }
+}
+
+PricingCache::Stats PricingCache::stats() const {
+    Stats st{hits.load(), misses.load(), evictions.load(), 0};
+    for (auto& s : shards) {
+        std::lock_guard<std::mutex> lock(s->mtx);
+        st.size += s->lru.size();
+    }
+    return st;
+}
+
+}
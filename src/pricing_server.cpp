@@ -0,0 +1,395 @@
+#include "pricing_server.h"
+#include "bond.h"
+#include "trace.h"
+#include <cstring>
+#include <cmath>
+#include <unordered_map>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <json/json.h>
+
+using namespace std;
+
+struct PricingServer::Connection {
+    int fd;
+    mutex writeMutex;
+    // Revaluation totals; only touched by the batch thread.
+    size_t revalCount = 0, revalErrors = 0;
+    double revalPv = 0.0, revalDv01 = 0.0, revalConvexity = 0.0;
+    explicit Connection(int f) : fd(f) {}
+    ~Connection() { close(fd); }
+
+    void send(const string& data) {
+        lock_guard<mutex> lock(writeMutex);
+        size_t off = 0;
+        while (off < data.size()) {
+            ssize_t n = ::send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+            if (n <= 0) return;
+            off += (size_t)n;
+        }
+    }
+};
+
+static void appendNumber(string& out, const char* key, double value) {
+    char buf[64];
+    if (std::isfinite(value)) snprintf(buf, sizeof(buf), ",\"%s\":%.17g", key, value);
+    else snprintf(buf, sizeof(buf), ",\"%s\":null", key);
+    out += buf;
+}
+
+static string escape(const string& s) {
+    string out;
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') out += '\\';
+        if ((unsigned char)ch >= 0x20) out += ch;
+    }
+    return out;
+}
+
+PricingServer::PricingServer(const ServerConfig& config)
+    : cfg(config), listenFd(-1), running(false), stopRequested(false), activeReaders(0) {
+    if (cfg.cacheCapacity > 0) cache = make_unique<Bonds::PricingCache>(cfg.cacheCapacity);
+}
+
+PricingServer::~PricingServer() {
+    stop();
+}
+
+// Field readers for client input: a missing key keeps the default, a key of
+// the wrong type (or out of range) fails instead of throwing from jsoncpp.
+static bool readNumber(const Json::Value& root, const char* key, double& out) {
+    if (!root.isMember(key)) return true;
+    const Json::Value& v = root[key];
+    if (!v.isNumeric() || !std::isfinite(v.asDouble())) return false;
+    out = v.asDouble();
+    return true;
+}
+
+static bool readInt(const Json::Value& root, const char* key, int& out) {
+    if (!root.isMember(key)) return true;
+    const Json::Value& v = root[key];
+    if (!v.isInt()) return false;
+    out = v.asInt();
+    return true;
+}
+
+static bool readString(const Json::Value& root, const char* key, string& out) {
+    if (!root.isMember(key)) return true;
+    const Json::Value& v = root[key];
+    if (!v.isString()) return false;
+    out = v.asString();
+    return true;
+}
+
+bool PricingServer::parseRequest(const string& line, PricingRequest& req) {
+    thread_local unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+    Json::Value root;
+    string errs;
+    bool parsed = false;
+    try {
+        parsed = reader->parse(line.data(), line.data() + line.size(), &root, &errs);
+    } catch (const Json::Exception&) {
+        // e.g. nesting beyond the reader's stack limit
+    }
+    if (!parsed || !root.isObject()) {
+        req.error = "invalid JSON";
+        return false;
+    }
+    if (root.isMember("id")) {
+        if (!root["id"].isInt64()) {
+            req.error = "id must be an integer";
+            return false;
+        }
+        req.id = root["id"].asInt64();
+    }
+    if (!readString(root, "symbol", req.symbol)) {
+        req.error = "symbol must be a string";
+        return false;
+    }
+
+    string op = "price";
+    if (!readString(root, "op", op)) { req.error = "op must be a string"; return false; }
+    if (op == "price") req.op = PricingRequest::Op::Price;
+    else if (op == "ytm") req.op = PricingRequest::Op::Ytm;
+    else if (op == "risk") req.op = PricingRequest::Op::Risk;
+    else if (op == "reval") req.op = PricingRequest::Op::Reval;
+    else if (op == "stats") { req.op = PricingRequest::Op::Stats; return true; }
+    else if (op == "total") { req.op = PricingRequest::Op::Total; return true; }
+    else { req.error = "unknown op: " + op; return false; }
+
+    string type = "coupon";
+    if (!readString(root, "type", type)) { req.error = "type must be a string"; return false; }
+    if (type == "zc") req.coupon = false;
+    else if (type == "coupon") req.coupon = true;
+    else { req.error = "unknown type: " + type; return false; }
+
+    if (!readNumber(root, "FV", req.FV) || !readNumber(root, "c", req.c) || !readNumber(root, "r", req.r) ||
+        !readNumber(root, "price", req.marketPrice) || !readNumber(root, "qty", req.quantity) ||
+        !readInt(root, "T", req.T) || !readInt(root, "freq", req.freq)) {
+        req.error = "bond terms must be finite numbers (T and freq integers)";
+        return false;
+    }
+
+    if (req.FV <= 0 || req.c < 0 || req.r < 0 || req.T <= 0 || req.freq <= 0) {
+        req.error = "invalid bond terms";
+        return false;
+    }
+    if ((int64_t)req.T * req.freq > PricingRequest::kMaxPeriods) {
+        req.error = "too many coupon periods (T*freq above " + to_string(PricingRequest::kMaxPeriods) + ")";
+        return false;
+    }
+    if (req.op == PricingRequest::Op::Ytm && req.marketPrice <= 0) {
+        req.error = "ytm needs a positive price";
+        return false;
+    }
+    return true;
+}
+
+string PricingServer::evaluate(const PricingRequest& req) {
+    string out = "{\"id\":" + to_string(req.id);
+    if (!req.symbol.empty()) out += ",\"symbol\":\"" + escape(req.symbol) + "\"";
+    if (!req.error.empty()) {
+        out += ",\"ok\":false,\"error\":\"" + escape(req.error) + "\"}\n";
+        return out;
+    }
+    out += ",\"ok\":true";
+
+    if (req.op == PricingRequest::Op::Stats) {
+        auto st = cache ? cache->stats() : Bonds::PricingCache::Stats{0, 0, 0, 0};
+        appendNumber(out, "cache_hits", (double)st.hits);
+        appendNumber(out, "cache_misses", (double)st.misses);
+        appendNumber(out, "cache_evictions", (double)st.evictions);
+        appendNumber(out, "cache_size", (double)st.size);
+        appendNumber(out, "cache_hit_rate", st.hitRate());
+    } else if (req.op == PricingRequest::Op::Ytm) {
+        double y = req.coupon ? Bonds::c_Bond(req.FV, req.c, req.r, req.T, req.freq).ytm(req.marketPrice)
+                              : Bonds::zc_Bond(req.FV, req.r, req.T).ytm(req.marketPrice);
+        appendNumber(out, "ytm", y);
+    } else {
+        auto key = req.coupon ? Bonds::PricingKey::couponBond(req.FV, req.c, req.r, req.T, req.freq)
+                              : Bonds::PricingKey::zeroCoupon(req.FV, req.r, req.T);
+        auto res = cache ? cache->get(key) : Bonds::PricingCache::compute(key);
+        appendNumber(out, "price", res.price);
+        if (req.op == PricingRequest::Op::Risk) {
+            appendNumber(out, "macaulay_duration", res.macaulay_duration);
+            appendNumber(out, "modified_duration", res.modified_duration);
+            appendNumber(out, "convexity", res.convexity);
+        }
+    }
+
+    out += "}\n";
+    return out;
+}
+
+bool PricingServer::listen() {
+    lock_guard<mutex> lock(listenMutex);
+    if (listenFd >= 0) return true;
+    int fd = -1;
+    auto fail = [&](string error) {
+        lastError = std::move(error);
+        if (fd >= 0) close(fd);
+        return false;
+    };
+    if (!cfg.unixPath.empty()) {
+        sockaddr_un addr{};
+        if (cfg.unixPath.size() >= sizeof(addr.sun_path)) return fail("socket path too long: " + cfg.unixPath);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, cfg.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(cfg.unixPath.c_str());
+        if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+            return fail("cannot bind " + cfg.unixPath + ": " + strerror(errno));
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)cfg.port);
+        if (inet_pton(AF_INET, cfg.host.c_str(), &addr.sin_addr) != 1)
+            return fail("invalid listen address: " + cfg.host);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+            return fail("cannot bind " + cfg.host + ":" + to_string(cfg.port) + ": " + strerror(errno));
+    }
+    if (::listen(fd, 128) != 0) return fail(string("listen failed: ") + strerror(errno));
+    listenFd = fd;
+    return true;
+}
+
+bool PricingServer::run() {
+    if (!listen()) return false;
+    {
+        // A stop() that came first wins; later ones find running set and shut the socket.
+        lock_guard<mutex> lock(listenMutex);
+        if (!stopRequested) running = true;
+    }
+    thread batcher(&PricingServer::batchLoop, this);
+    if (running) acceptLoop();
+    {
+        lock_guard<mutex> lock(listenMutex);
+        running = false;
+        close(listenFd);
+        listenFd = -1;
+    }
+
+    queueCv.notify_all();
+    batcher.join();
+    {
+        unique_lock<mutex> lock(connMutex);
+        for (auto& conn : connections) shutdown(conn->fd, SHUT_RDWR);
+        readersDone.wait(lock, [this] { return activeReaders == 0; });
+    }
+    if (!cfg.unixPath.empty()) unlink(cfg.unixPath.c_str());
+    return true;
+}
+
+void PricingServer::stop() {
+    {
+        lock_guard<mutex> lock(listenMutex);
+        stopRequested = true;
+        if (!running.exchange(false)) return;
+        // Wakes accept(); the descriptor itself is closed by run().
+        if (listenFd >= 0) shutdown(listenFd, SHUT_RDWR);
+    }
+    queueCv.notify_all();
+}
+
+void PricingServer::acceptLoop() {
+    while (running) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (cfg.unixPath.empty()) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        auto conn = make_shared<Connection>(fd);
+        lock_guard<mutex> lock(connMutex);
+        connections.push_back(conn);
+        activeReaders++;
+        thread(&PricingServer::readLoop, this, conn).detach();
+    }
+}
+
+void PricingServer::readLoop(shared_ptr<Connection> conn) {
+    string buf;
+    char chunk[65536];
+    vector<Pending> parsed;
+    while (running) {
+        ssize_t n = recv(conn->fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) break;
+        buf.append(chunk, (size_t)n);
+
+        size_t start = 0, nl;
+        bool tooLong = false;
+        while (!tooLong && (nl = buf.find('\n', start)) != string::npos) {
+            tooLong = nl - start > cfg.maxLineBytes;
+            string line = buf.substr(start, nl - start);
+            start = nl + 1;
+            if (tooLong || line.find_first_not_of(" \t\r") == string::npos) continue;
+            Pending p{conn, {}};
+            parseRequest(line, p.req);
+            parsed.push_back(std::move(p));
+        }
+        buf.erase(0, start);
+        tooLong = tooLong || buf.size() > cfg.maxLineBytes;
+
+        // Everything decoded from one read goes onto the queue under a single lock.
+        if (!parsed.empty()) {
+            {
+                lock_guard<mutex> lock(queueMutex);
+                for (auto& p : parsed) queue.push_back(std::move(p));
+            }
+            queueCv.notify_one();
+            parsed.clear();
+        }
+        if (tooLong) {
+            PricingRequest req;
+            req.error = "request line longer than " + to_string(cfg.maxLineBytes) + " bytes";
+            conn->send(evaluate(req));
+            shutdown(conn->fd, SHUT_RD);
+            break;
+        }
+    }
+    lock_guard<mutex> lock(connMutex);
+    for (size_t i = 0; i < connections.size(); i++) {
+        if (connections[i] == conn) {
+            connections.erase(connections.begin() + i);
+            break;
+        }
+    }
+    activeReaders--;
+    readersDone.notify_all();
+}
+
+void PricingServer::batchLoop() {
+    vector<Pending> batch;
+    while (true) {
+        {
+            unique_lock<mutex> lock(queueMutex);
+            queueCv.wait(lock, [this] { return !queue.empty() || !running; });
+            if (queue.empty() && !running) return;
+            size_t n = min(queue.size(), cfg.maxBatch);
+            batch.assign(make_move_iterator(queue.begin()), make_move_iterator(queue.begin() + n));
+            queue.erase(queue.begin(), queue.begin() + n);
+        }
+        processBatch(batch);
+        batch.clear();
+    }
+}
+
+void PricingServer::processBatch(vector<Pending>& batch) {
+    string size;
+    if (Trace::isEnabled()) size = to_string(batch.size());
+    TRACE_SCOPE_ARG("price_batch", "price", "requests", size);
+    // Responses for the same connection are coalesced into one write.
+    unordered_map<Connection*, string> replies;
+    vector<Connection*> order;
+    for (auto& p : batch) {
+        if (p.req.op == PricingRequest::Op::Reval) {
+            accumulate(*p.conn, p.req);
+            continue;
+        }
+        auto& out = replies[p.conn.get()];
+        if (out.empty()) order.push_back(p.conn.get());
+        out += p.req.op == PricingRequest::Op::Total ? takeTotals(*p.conn, p.req) : evaluate(p.req);
+    }
+    for (Connection* conn : order) conn->send(replies[conn]);
+}
+
+void PricingServer::accumulate(Connection& conn, const PricingRequest& req) {
+    if (!req.error.empty()) {
+        conn.revalErrors++;
+        return;
+    }
+    auto key = req.coupon ? Bonds::PricingKey::couponBond(req.FV, req.c, req.r, req.T, req.freq)
+                          : Bonds::PricingKey::zeroCoupon(req.FV, req.r, req.T);
+    auto res = cache ? cache->get(key) : Bonds::PricingCache::compute(key);
+    if (!std::isfinite(res.price)) {
+        conn.revalErrors++;
+        return;
+    }
+    conn.revalCount++;
+    conn.revalPv += req.quantity * res.price;
+    conn.revalDv01 += req.quantity * res.price * res.modified_duration * 1e-4;
+    conn.revalConvexity += req.quantity * res.price * res.convexity;
+}
+
+string PricingServer::takeTotals(Connection& conn, const PricingRequest& req) {
+    string out = "{\"id\":" + to_string(req.id) + ",\"ok\":true";
+    appendNumber(out, "count", (double)conn.revalCount);
+    appendNumber(out, "pv", conn.revalPv);
+    appendNumber(out, "dv01", conn.revalDv01);
+    appendNumber(out, "convexity", conn.revalConvexity);
+    appendNumber(out, "errors", (double)conn.revalErrors);
+    out += "}\n";
+    conn.revalCount = conn.revalErrors = 0;
+    conn.revalPv = conn.revalDv01 = conn.revalConvexity = 0.0;
+    return out;
+}
@@ -0,0 +1,287 @@
+#include "reval_coordinator.h"
+#include "trace.h"
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <csignal>
+#include <spawn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <netdb.h>
+#include <json/json.h>
+
+using namespace std;
+
+extern char** environ;
+
+RevalCoordinator::RevalCoordinator(const RevalConfig& config) : cfg(config), endpoints(config.endpoints) {}
+
+RevalCoordinator::~RevalCoordinator() {
+    for (size_t i = 0; i < workers.size(); i++) stopWorker(i);
+}
+
+uint32_t RevalCoordinator::shardOf(const string& name, size_t shards) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    for (unsigned char ch : name) {
+        h ^= ch;
+        h *= 16777619u;
+    }
+    return shards ? h % shards : 0;
+}
+
+static bool isZeroCoupon(const string& type) {
+    return type == "zc" || type == "Zero-Coupon";
+}
+
+static bool isFinite(const RevalPosition& p) {
+    return isfinite(p.FV) && isfinite(p.c) && isfinite(p.r) && isfinite(p.quantity);
+}
+
+vector<RevalPosition> RevalCoordinator::fromRecords(const vector<BondRecord>& rows, size_t* skipped) {
+    vector<RevalPosition> book;
+    book.reserve(rows.size());
+    size_t bad = 0;
+    for (const auto& r : rows) {
+        RevalPosition p{r.name, !isZeroCoupon(r.type), r.FV, r.c, r.r, r.T, r.freq, 1.0};
+        if (isFinite(p)) book.push_back(p);
+        else bad++;
+    }
+    if (skipped) *skipped = bad;
+    return book;
+}
+
+bool RevalCoordinator::loadSnapshot(const string& path, vector<RevalPosition>& out, string& error, size_t* skipped) {
+    ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    string line;
+    size_t bad = 0;
+    bool first = true;
+    while (getline(in, line)) {
+        bool header = first;
+        first = false;
+        if (line.empty()) continue;
+        vector<string> f;
+        stringstream ss(line);
+        string cell;
+        while (getline(ss, cell, ',')) f.push_back(cell);
+        char* end = nullptr;
+        double FV = f.size() >= 7 ? strtod(f[2].c_str(), &end) : 0.0;
+        if (f.size() < 7 || end == f[2].c_str()) {
+            if (!header) bad++;
+            continue;
+        }
+        RevalPosition p{f[0], !isZeroCoupon(f[1]), FV, atof(f[3].c_str()), atof(f[4].c_str()),
+                        atoi(f[5].c_str()), atoi(f[6].c_str()), f.size() > 7 ? atof(f[7].c_str()) : 1.0};
+        if (isFinite(p)) out.push_back(p);
+        else bad++;
+    }
+    if (skipped) *skipped = bad;
+    return true;
+}
+
+bool RevalCoordinator::startWorker(size_t shard, string& error) {
+    string path = endpoints[shard];
+    unlink(path.c_str());
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    char arg0[] = "bond_pricer", arg1[] = "--serve";
+    char* argv[] = {arg0, arg1, path.data(), nullptr};
+    pid_t pid;
+    int rc = posix_spawn(&pid, cfg.workerExe.c_str(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0) {
+        error = "cannot start worker: " + string(strerror(rc));
+        workers[shard] = -1;
+        return false;
+    }
+    workers[shard] = pid;
+    return true;
+}
+
+void RevalCoordinator::stopWorker(size_t shard) {
+    if (workers[shard] <= 0) return;
+    kill(workers[shard], SIGTERM);
+    waitpid(workers[shard], nullptr, 0);
+    unlink(endpoints[shard].c_str());
+    workers[shard] = -1;
+}
+
+// Connects to a Unix socket path or host:port, retrying while a freshly
+// started worker is still binding.
+static int connectTo(const string& endpoint, int waitMs) {
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(waitMs);
+    while (true) {
+        int fd = -1;
+        if (endpoint.find('/') != string::npos) {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, endpoint.c_str(), sizeof(addr.sun_path) - 1);
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0) return fd;
+        } else {
+            auto colon = endpoint.rfind(':');
+            string host = colon == string::npos ? "127.0.0.1" : endpoint.substr(0, colon);
+            string port = colon == string::npos ? endpoint : endpoint.substr(colon + 1);
+            addrinfo hints{}, *res = nullptr;
+            hints.ai_socktype = SOCK_STREAM;
+            if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) == 0) {
+                fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+                bool ok = fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) == 0;
+                freeaddrinfo(res);
+                if (ok) return fd;
+            }
+        }
+        if (fd >= 0) close(fd);
+        if (chrono::steady_clock::now() >= deadline) return -1;
+        this_thread::sleep_for(chrono::milliseconds(20));
+    }
+}
+
+static const int64_t kTotalId = 1;
+
+bool RevalCoordinator::runShard(size_t shard, const string& payload, size_t positions, ShardTotal& out,
+                                string& error) {
+    int fd = connectTo(endpoints[shard], 5000);
+    if (fd < 0) {
+        error = "cannot connect to " + endpoints[shard];
+        return false;
+    }
+    auto budget = chrono::milliseconds(cfg.timeoutMs + (int64_t)(cfg.timeoutPerPositionMs * positions));
+    auto deadline = chrono::steady_clock::now() + budget;
+    auto ms = budget.count();
+    timeval tv{(time_t)(ms / 1000), (suseconds_t)((ms % 1000) * 1000)};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    size_t off = 0;
+    while (off < payload.size()) {
+        ssize_t n = send(fd, payload.data() + off, payload.size() - off, MSG_NOSIGNAL);
+        if (n <= 0) {
+            close(fd);
+            error = "send to " + endpoints[shard] + " failed";
+            return false;
+        }
+        off += (size_t)n;
+    }
+
+    // Error replies to individual lines may come first; read until the
+    // reply carrying the total's id, within the shard's time budget.
+    Json::Value root;
+    string reply, errs;
+    unique_ptr<Json::CharReader> reader(Json::CharReaderBuilder().newCharReader());
+    char buf[4096];
+    bool found = false;
+    while (!found) {
+        size_t nl = reply.find('\n');
+        if (nl == string::npos) {
+            auto left = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+            pollfd pfd{fd, POLLIN, 0};
+            if (left <= 0 || poll(&pfd, 1, (int)min<int64_t>(left, INT32_MAX)) <= 0) break;
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            reply.append(buf, (size_t)n);
+            continue;
+        }
+        found = reader->parse(reply.data(), reply.data() + nl, &root, &errs) && root.isObject() &&
+                root["id"].isInt64() && root["id"].asInt64() == kTotalId;
+        reply.erase(0, nl + 1);
+    }
+    close(fd);
+
+    if (!found || !root.get("ok", false).asBool()) {
+        error = "no totals from " + endpoints[shard];
+        return false;
+    }
+    out.count = root["count"].asUInt64();
+    out.errors = root["errors"].asUInt64();
+    out.pv = root["pv"].asDouble();
+    out.dv01 = root["dv01"].asDouble();
+    out.convexity = root["convexity"].asDouble();
+    return true;
+}
+
+RevalReport RevalCoordinator::run(const vector<RevalPosition>& book) {
+    TRACE_SCOPE("reval", "reval");
+    auto started = chrono::steady_clock::now();
+    RevalReport report;
+    report.positions = book.size();
+
+    if (endpoints.empty()) {
+        size_t n = cfg.spawn ? cfg.spawn : max(1u, thread::hardware_concurrency());
+        for (size_t k = 0; k < n; k++)
+            endpoints.push_back("/tmp/bond_pricer-" + to_string(getpid()) + "-" + to_string(k) + ".sock");
+        workers.assign(n, -1);
+        for (size_t k = 0; k < n; k++) {
+            if (!startWorker(k, report.error_message)) return report;
+        }
+    }
+    size_t shards = endpoints.size();
+
+    // Shard payloads keep book order, which fixes each worker's summation order.
+    vector<string> payloads(shards);
+    vector<size_t> sizes(shards, 0);
+    size_t rejected = 0;
+    char buf[512];
+    for (const auto& p : book) {
+        if (!isFinite(p)) {     // would not survive the JSON encoding
+            rejected++;
+            continue;
+        }
+        snprintf(buf, sizeof(buf),
+                 "{\"op\":\"reval\",\"type\":\"%s\",\"FV\":%.17g,\"c\":%.17g,\"r\":%.17g,\"T\":%d,\"freq\":%d,\"qty\":%.17g}\n",
+                 p.coupon ? "coupon" : "zc", p.FV, p.c, p.r, p.T, p.freq, p.quantity);
+        uint32_t k = shardOf(p.name, shards);
+        payloads[k] += buf;
+        sizes[k]++;
+    }
+    for (auto& payload : payloads) payload += "{\"id\":" + to_string(kTotalId) + ",\"op\":\"total\"}\n";
+
+    report.shards.resize(shards);
+    vector<string> errors(shards);
+    vector<char> ok(shards, 0);
+    vector<thread> pool;
+    for (size_t k = 0; k < shards; k++) {
+        pool.emplace_back([&, k] {
+            for (int attempt = 0; attempt <= cfg.maxRestarts && !ok[k]; attempt++) {
+                report.shards[k].attempts = attempt + 1;
+                if (attempt > 0 && !workers.empty()) {
+                    stopWorker(k);
+                    if (!startWorker(k, errors[k])) continue;
+                }
+                ok[k] = runShard(k, payloads[k], sizes[k], report.shards[k], errors[k]);
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+
+    for (size_t k = 0; k < shards; k++) {
+        if (!ok[k]) {
+            report.error_message = "shard " + to_string(k) + ": " + errors[k];
+            return report;
+        }
+        const ShardTotal& s = report.shards[k];
+        report.total.count += s.count;
+        report.total.errors += s.errors;
+        report.total.pv += s.pv;
+        report.total.dv01 += s.dv01;
+        report.total.convexity += s.convexity;
+        report.total.attempts += s.attempts;
+    }
+    report.total.errors += rejected;
+    report.success = true;
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    return report;
+}
@@ -0,0 +1,317 @@
+#include "schedule.h"
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <functional>
+
+namespace Bonds {
+
+// Civil-date conversions after H. Hinnant's days_from_civil / civil_from_days.
+static int32_t daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    unsigned yoe = (unsigned)(y - era * 400);
+    unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static bool isLeap(int y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; }
+
+static int daysInMonth(int y, int m) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return m == 2 && isLeap(y) ? 29 : days[m - 1];
+}
+
+Date::Date(int year, int month, int day) : serial(daysFromCivil(year, month, day)) {}
+
+void Date::ymd(int& year, int& month, int& day) const {
+    int32_t z = serial + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    unsigned doe = (unsigned)(z - era * 146097);
+    unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int y = (int)yoe + era * 400;
+    unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned mp = (5 * doy + 2) / 153;
+    day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    year = y + (month <= 2);
+}
+
+int Date::weekday() const {
+    // 1970-01-01 was a Thursday
+    int w = (serial + 3) % 7;
+    return w < 0 ? w + 7 : w;
+}
+
+Date Date::addMonths(int months) const {
+    int y, m, d;
+    ymd(y, m, d);
+    int total = y * 12 + (m - 1) + months;
+    y = total >= 0 ? total / 12 : (total - 11) / 12;
+    m = total - y * 12 + 1;
+    return Date(y, m, std::min(d, daysInMonth(y, m)));
+}
+
+bool Date::isEndOfMonth() const {
+    int y, m, d;
+    ymd(y, m, d);
+    return d == daysInMonth(y, m);
+}
+
+std::string Date::str() const {
+    int y, m, d;
+    ymd(y, m, d);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
+    return buf;
+}
+
+bool Date::parse(const std::string& s, Date& out) {
+    int y, m, d;
+    if (sscanf(s.c_str(), "%d-%d-%d", &y, &m, &d) != 3) return false;
+    if (m < 1 || m > 12 || d < 1 || d > daysInMonth(y, m)) return false;
+    out = Date(y, m, d);
+    return true;
+}
+
+double yearFraction(DayCount dc, Date start, Date end, Date refStart, Date refEnd, int freq) {
+    switch (dc) {
+        case DayCount::ACT_360:
+            return (end - start) / 360.0;
+        case DayCount::THIRTY_360: {
+            int y1, m1, d1, y2, m2, d2;
+            start.ymd(y1, m1, d1);
+            end.ymd(y2, m2, d2);
+            if (d1 == 31) d1 = 30;
+            if (d2 == 31 && d1 == 30) d2 = 30;
+            return (360 * (y2 - y1) + 30 * (m2 - m1) + (d2 - d1)) / 360.0;
+        }
+        case DayCount::ACT_ACT:
+        default: {
+            int ref = refEnd - refStart;
+            if (ref <= 0 || freq <= 0) return (end - start) / 365.0;
+            return double(end - start) / (double(ref) * freq);
+        }
+    }
+}
+
+Calendar::Calendar(std::string name, std::vector<Date> hols) : id(std::move(name)) {
+    for (const auto& h : hols) holidays.push_back(h.days());
+    std::sort(holidays.begin(), holidays.end());
+}
+
+bool Calendar::isBusinessDay(Date d) const {
+    if (d.weekday() >= 5) return false;
+    return !std::binary_search(holidays.begin(), holidays.end(), d.days());
+}
+
+Date Calendar::adjust(Date d, BusinessDayConvention bdc) const {
+    if (bdc == BusinessDayConvention::Unadjusted) return d;
+    Date a = d;
+    if (bdc == BusinessDayConvention::Preceding) {
+        while (!isBusinessDay(a)) a = a.addDays(-1);
+        return a;
+    }
+    while (!isBusinessDay(a)) a = a.addDays(1);
+    if (bdc == BusinessDayConvention::ModifiedFollowing) {
+        int y1, m1, d1, y2, m2, d2;
+        d.ymd(y1, m1, d1);
+        a.ymd(y2, m2, d2);
+        if (m1 != m2) {
+            a = d;
+            while (!isBusinessDay(a)) a = a.addDays(-1);
+        }
+    }
+    return a;
+}
+
+bool ScheduleSpec::operator==(const ScheduleSpec& o) const {
+    auto calName = [](const ScheduleSpec& s) { return s.calendar ? s.calendar->name() : std::string(); };
+    return issue == o.issue && maturity == o.maturity && faceValue == o.faceValue && coupon == o.coupon &&
+           freq == o.freq && dayCount == o.dayCount && convention == o.convention && stub == o.stub &&
+           calName(*this) == calName(o);
+}
+
+size_t ScheduleSpecHash::operator()(const ScheduleSpec& s) const {
+    size_t h = std::hash<int32_t>()(s.issue.days());
+    auto mix = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+    mix(std::hash<int32_t>()(s.maturity.days()));
+    mix(std::hash<double>()(s.faceValue));
+    mix(std::hash<double>()(s.coupon));
+    mix((size_t)s.freq << 8 | (size_t)s.dayCount << 4 | (size_t)s.convention << 2 | (size_t)s.stub);
+    if (s.calendar) mix(std::hash<std::string>()(s.calendar->name()));
+    return h;
+}
+
+// Accrual fraction of one schedule period. Under ACT/ACT a stub is measured
+// against the notional regular periods rolled from its regular end (front
+// stubs) or start (back stubs), so a long stub counts whole periods plus the
+// remainder.
+static double periodFraction(DayCount dc, Date start, Date end, int months, int freq, bool backward) {
+    if (dc != DayCount::ACT_ACT) return yearFraction(dc, start, end, start, end, freq);
+    double factor = 0.0;
+    if (backward) {
+        Date cursor = end;
+        while (start < cursor.addMonths(-months)) {
+            factor += 1.0 / freq;
+            cursor = cursor.addMonths(-months);
+        }
+        return factor + yearFraction(dc, start, cursor, cursor.addMonths(-months), cursor, freq);
+    }
+    Date cursor = start;
+    while (cursor.addMonths(months) < end) {
+        factor += 1.0 / freq;
+        cursor = cursor.addMonths(months);
+    }
+    return factor + yearFraction(dc, cursor, end, cursor, cursor.addMonths(months), freq);
+}
+
+std::shared_ptr<const Schedule> Schedule::generate(const ScheduleSpec& spec) {
+    auto out = std::make_shared<Schedule>();
+    out->faceValue = spec.faceValue;
+    out->coupon = spec.coupon;
+    out->freq = spec.freq;
+    out->dayCount = spec.dayCount;
+    out->months = 0;
+    out->rollBackward = spec.stub == StubType::ShortFront || spec.stub == StubType::LongFront;
+    if (spec.freq <= 0 || 12 % spec.freq != 0 || !(spec.issue < spec.maturity)) return out;
+
+    int months = 12 / spec.freq;
+    out->months = months;
+    bool backward = out->rollBackward;
+    bool longStub = spec.stub == StubType::LongFront || spec.stub == StubType::LongBack;
+
+    // Roll from the anchor date in whole periods so month-end dates do not drift.
+    std::vector<Date> dates;
+    if (backward) {
+        dates.push_back(spec.maturity);
+        for (int k = 1;; k++) {
+            Date d = spec.maturity.addMonths(-k * months);
+            if (d <= spec.issue) break;
+            dates.push_back(d);
+        }
+        dates.push_back(spec.issue);
+        std::reverse(dates.begin(), dates.end());
+    } else {
+        dates.push_back(spec.issue);
+        for (int k = 1;; k++) {
+            Date d = spec.issue.addMonths(k * months);
+            if (spec.maturity <= d) break;
+            dates.push_back(d);
+        }
+        dates.push_back(spec.maturity);
+    }
+
+    // An irregular stub is merged into its neighbour when a long stub was asked for.
+    if (longStub && dates.size() > 2) {
+        if (backward && !(dates[1].addMonths(-months) == dates[0])) dates.erase(dates.begin() + 1);
+        if (!backward && !(dates[dates.size() - 2].addMonths(months) == dates.back())) dates.erase(dates.end() - 2);
+    }
+
+    static const Calendar weekends;
+    const Calendar& cal = spec.calendar ? *spec.calendar : weekends;
+    size_t n = dates.size() - 1;
+    out->accrualStart.reserve(n);
+    out->accrualEnd.reserve(n);
+    out->payDate.reserve(n);
+    out->accrualFactor.reserve(n);
+    out->periodLength.reserve(n);
+    out->amount.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        Date start = dates[i], end = dates[i + 1];
+        double factor = periodFraction(spec.dayCount, start, end, months, spec.freq, backward);
+        out->accrualStart.push_back(start.days());
+        out->accrualEnd.push_back(end.days());
+        out->payDate.push_back(cal.adjust(end, spec.convention).days());
+        out->accrualFactor.push_back(factor);
+        out->periodLength.push_back(periodFraction(DayCount::ACT_ACT, start, end, months, spec.freq, backward) * spec.freq);
+        out->amount.push_back(spec.faceValue * spec.coupon * factor);
+    }
+    out->amount.back() += spec.faceValue;
+    return out;
+}
+
+static size_t periodContaining(const Schedule& s, Date settle) {
+    // First period whose payment is still owed to the buyer.
+    return std::upper_bound(s.payDate.begin(), s.payDate.end(), settle.days()) - s.payDate.begin();
+}
+
+// Regular periods of period k elapsed at settle, on the same notional
+// periods as periodLength (rolled from the period's anchor end).
+static double elapsedPeriods(const Schedule& s, size_t k, Date settle) {
+    Date start(s.accrualStart[k]), end(s.accrualEnd[k]);
+    if (settle <= start) return 0.0;
+    if (end <= settle) return s.periodLength[k];
+    if (s.rollBackward)
+        return s.periodLength[k] - periodFraction(DayCount::ACT_ACT, settle, end, s.months, s.freq, true) * s.freq;
+    return periodFraction(DayCount::ACT_ACT, start, settle, s.months, s.freq, false) * s.freq;
+}
+
+static double accruedFor(const Schedule& s, size_t k, Date settle) {
+    if (k >= s.size() || settle.days() <= s.accrualStart[k]) return 0.0;
+    Date start(s.accrualStart[k]), end(s.accrualEnd[k]);
+    if (end < settle) return 0.0;
+    double part = s.dayCount == DayCount::ACT_ACT
+        ? elapsedPeriods(s, k, settle) / s.freq
+        : yearFraction(s.dayCount, start, settle, start, end, s.freq);
+    return s.faceValue * s.coupon * part;
+}
+
+double accruedInterest(const Schedule& s, Date settle) {
+    return accruedFor(s, periodContaining(s, settle), settle);
+}
+
+DatedPrice priceDated(const Schedule& s, Date settle, double yield) {
+    size_t k = periodContaining(s, settle);
+    if (k >= s.size()) return {0.0, 0.0, 0.0};
+
+    // Regular periods still to run in the current (possibly stub) period.
+    double w = std::max(0.0, s.periodLength[k] - elapsedPeriods(s, k, settle));
+
+    double v = 1.0 / (1.0 + yield / s.freq);
+    double df = std::pow(v, w);
+    double pv = 0.0;
+    const double* amt = s.amount.data();
+    const double* len = s.periodLength.data();
+    pv += amt[k] * df;
+    for (size_t i = k + 1; i < s.size(); i++) {
+        df *= len[i] == 1.0 ? v : std::pow(v, len[i]);
+        pv += amt[i] * df;
+    }
+    double ai = accruedFor(s, k, settle);
+    return {pv, pv - ai, ai};
+}
+
+DatedPrice priceDated(const Schedule& s, Date settle, const YieldCurve& curve) {
+    size_t k = periodContaining(s, settle);
+    if (k >= s.size()) return {0.0, 0.0, 0.0};
+    double pv = 0.0;
+    for (size_t i = k; i < s.size(); i++)
+        pv += s.amount[i] * curve.discount((s.payDate[i] - settle.days()) / 365.0);
+    double ai = accruedFor(s, k, settle);
+    return {pv, pv - ai, ai};
+}
+
+std::shared_ptr<const Schedule> ScheduleCache::get(const ScheduleSpec& spec) {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = schedules.find(spec);
+        if (it != schedules.end()) return it->second;
+    }
+    auto generated = Schedule::generate(spec);
+    std::lock_guard<std::mutex> lock(mtx);
+    return schedules.emplace(spec, generated).first->second;
+}
+
+size_t ScheduleCache::size() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return schedules.size();
+}
+
+void ScheduleCache::clear() {
+    std::lock_guard<std::mutex> lock(mtx);
+    schedules.clear();
+}
+
+}
@@ -0,0 +1,126 @@
+#include "spread_solver.h"
+#include "trace.h"
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+namespace Bonds {
+
+static const int kMaxIter = 50;
+static const double kPriceTol = 1e-10;
+
+void SpreadSolver::zSpreads(const std::vector<Instrument>& book, const std::vector<double>& prices,
+                            const YieldCurve& curve, std::vector<SpreadResult>& out) {
+    TRACE_SCOPE("z_spreads", "risk");
+    size_t n = std::min(book.size(), prices.size());
+    lastZ.resize(n, 0.0);
+    out.resize(n);
+
+    // Curve discounting is done once per cashflow; Newton steps then only
+    // rescale the flattened PVs by exp(-s t).
+    cfTime.clear();
+    cfPv.clear();
+    start.assign(1, 0);
+    for (size_t i = 0; i < n; i++) {
+        cashflows(book[i], curve, scratch);
+        for (const auto& cf : scratch) {
+            cfTime.push_back(cf.time);
+            cfPv.push_back(cf.amount * cf.discount);
+        }
+        start.push_back((uint32_t)cfTime.size());
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const double* t = cfTime.data() + start[i];
+        const double* pv = cfPv.data() + start[i];
+        size_t m = start[i + 1] - start[i];
+        double target = prices[i];
+        SpreadResult res{lastZ[i], 0, false};
+        if (m == 0 || !(target > 0)) {
+            out[i] = {NAN, 0, false};
+            continue;
+        }
+        double s = res.spread;
+        for (int it = 1; it <= kMaxIter; it++) {
+            double f = -target, d = 0.0;
+            for (size_t k = 0; k < m; k++) {
+                double v = pv[k] * std::exp(-s * t[k]);
+                f += v;
+                d += v * t[k];
+            }
+            res.iterations = it;
+            if (std::fabs(f) <= kPriceTol * target) {
+                res.converged = true;
+                break;
+            }
+            if (d <= 0.0) break;
+            s += f / d;
+        }
+        res.spread = s;
+        if (res.converged) lastZ[i] = s;
+        out[i] = res;
+    }
+}
+
+void SpreadSolver::oas(const HullWhiteLattice& lattice, const std::vector<CallableBond>& bonds,
+                       const std::vector<double>& prices, std::vector<SpreadResult>& out, size_t threads) {
+    TRACE_SCOPE("oas", "risk");
+    size_t n = std::min(bonds.size(), prices.size());
+    lastOas.resize(n, 0.0);
+    out.resize(n);
+
+    // Secant on the lattice price; each evaluation is a full backward induction.
+    auto solve = [&](size_t i) {
+        double target = prices[i];
+        double s0 = lastOas[i], f0 = lattice.price(bonds[i], s0) - target;
+        double s1 = s0 + 1e-3, f1 = 0.0;
+        SpreadResult res{s0, 1, false};
+        if (!std::isfinite(f0) || !(target > 0)) {
+            out[i] = {NAN, 1, false};
+            return;
+        }
+        if (std::fabs(f0) <= 1e-9 * target) {
+            res.converged = true;
+        } else {
+            for (int it = 2; it <= kMaxIter; it++) {
+                f1 = lattice.price(bonds[i], s1) - target;
+                res.iterations = it;
+                if (!std::isfinite(f1)) break;
+                if (std::fabs(f1) <= 1e-9 * target) {
+                    res.spread = s1;
+                    res.converged = true;
+                    break;
+                }
+                if (f1 == f0) break;
+                double next = s1 - f1 * (s1 - s0) / (f1 - f0);
+                s0 = s1;
+                f0 = f1;
+                s1 = next;
+            }
+        }
+        if (res.converged) lastOas[i] = res.spread;
+        else res.spread = s1;
+        out[i] = res;
+    };
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<size_t>(1, n / 16));
+    if (threads <= 1) {
+        for (size_t i = 0; i < n; i++) solve(i);
+        return;
+    }
+    std::vector<std::thread> pool;
+    size_t chunk = (n + threads - 1) / threads;
+    for (size_t t = 0; t < threads; t++) {
+        size_t begin = t * chunk, end = std::min(n, begin + chunk);
+        if (begin < end) pool.emplace_back([&, begin, end] { for (size_t i = begin; i < end; i++) solve(i); });
+    }
+    for (auto& t : pool) t.join();
+}
+
+void SpreadSolver::reset() {
+    lastZ.clear();
+    lastOas.clear();
+}
+
+}
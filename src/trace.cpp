@@ -0,0 +1,97 @@
+#include "trace.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <unistd.h>
+
+namespace Trace {
+
+std::atomic<bool> enabled{false};
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* category;
+    int64_t ts;
+    int64_t dur;
+    const char* argName;
+    std::string argValue;
+};
+
+struct Buffer {
+    int tid;
+    std::vector<Event> events;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<Buffer>> registry;  // owns buffers beyond their thread's lifetime
+int64_t originUs = 0;
+
+// The registry lock is taken once per thread, on its first event.
+Buffer& localBuffer() {
+    thread_local Buffer* buf = nullptr;
+    if (!buf) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<Buffer>());
+        buf = registry.back().get();
+        buf->tid = (int)registry.size();
+        buf->events.reserve(4096);
+    }
+    return *buf;
+}
+
+void writeEscaped(std::ofstream& out, const char* s) {
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        if ((unsigned char)*s >= 0x20) out << *s;
+    }
+}
+
+}
+
+void start() {
+    originUs = nowUs();
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+void record(const char* name, const char* category, int64_t startUs, int64_t durUs,
+            const char* argName, const std::string* argValue) {
+    localBuffer().events.push_back({name, category, startUs, durUs, argName, argValue ? *argValue : std::string()});
+}
+
+bool dump(const std::string& path) {
+    enabled.store(false, std::memory_order_relaxed);
+    std::ofstream out(path);
+    if (!out) return false;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    int pid = (int)getpid();
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buf : registry) {
+        for (const auto& e : buf->events) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "{\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buf->tid << ",\"ts\":" << e.ts - originUs
+                << ",\"dur\":" << e.dur << ",\"name\":\"";
+            writeEscaped(out, e.name);
+            out << "\",\"cat\":\"";
+            writeEscaped(out, e.category);
+            out << "\"";
+            if (e.argName) {
+                out << ",\"args\":{\"";
+                writeEscaped(out, e.argName);
+                out << "\":\"";
+                writeEscaped(out, e.argValue.c_str());
+                out << "\"}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    return (bool)out;
+}
+
+}
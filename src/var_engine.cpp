@@ -0,0 +1,189 @@
+#include "var_engine.h"
+#include "trace.h"
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+
+namespace Bonds {
+
+CurveHistory CurveHistory::loadCsv(const std::string& path) {
+    CurveHistory h;
+    std::ifstream in(path);
+    if (!in) {
+        h.error_message = "cannot open " + path;
+        return h;
+    }
+    std::string line;
+    size_t lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#') continue;
+        std::vector<double> row;
+        std::stringstream ss(line);
+        std::string cell;
+        while (std::getline(ss, cell, ',')) {
+            char* end = nullptr;
+            double v = std::strtod(cell.c_str(), &end);
+            if (end == cell.c_str()) {
+                h.error_message = "bad number on line " + std::to_string(lineNo);
+                return h;
+            }
+            row.push_back(v);
+        }
+        if (h.tenors.empty()) {
+            h.tenors = std::move(row);
+        } else if (row.size() != h.tenors.size()) {
+            h.error_message = "line " + std::to_string(lineNo) + " has " + std::to_string(row.size()) +
+                              " moves, expected " + std::to_string(h.tenors.size());
+            return h;
+        } else {
+            h.moves.push_back(std::move(row));
+        }
+    }
+    if (h.tenors.empty() || h.moves.empty()) {
+        h.error_message = "no scenarios in " + path;
+        return h;
+    }
+    h.success = true;
+    return h;
+}
+
+double CurveHistory::moveAt(size_t s, double t) const {
+    const auto& m = moves[s];
+    if (t <= tenors.front()) return m.front();
+    if (t >= tenors.back()) return m.back();
+    size_t i = std::upper_bound(tenors.begin(), tenors.end(), t) - tenors.begin();
+    double w = (t - tenors[i-1]) / (tenors[i] - tenors[i-1]);
+    return m[i-1] + w * (m[i] - m[i-1]);
+}
+
+// Runs f(task) for task in [0, tasks) on a pool pulling from a shared counter.
+static void parallelFor(size_t tasks, size_t threads, const std::function<void(size_t)>& f) {
+    threads = std::min(threads, tasks);
+    if (threads <= 1) {
+        for (size_t i = 0; i < tasks; i++) f(i);
+        return;
+    }
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; t++)
+        pool.emplace_back([&] {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < tasks;) f(i);
+        });
+    for (auto& t : pool) t.join();
+}
+
+static double maturityOf(const Instrument& inst) {
+    return std::visit([](const auto& b) { return b.T; }, inst);
+}
+
+VarReport runHistoricalVar(const std::vector<Position>& book, const YieldCurve& base,
+                           const CurveHistory& history, const VarConfig& config) {
+    TRACE_SCOPE("historical_var", "risk");
+    auto started = std::chrono::steady_clock::now();
+    VarReport report;
+    if (!history.success || history.moves.empty()) {
+        report.error_message = history.error_message.empty() ? "empty history" : history.error_message;
+        return report;
+    }
+    if (!(config.confidence > 0.0 && config.confidence < 1.0)) {
+        report.error_message = "confidence must be in (0, 1)";
+        return report;
+    }
+
+    size_t n = book.size(), S = history.moves.size();
+    size_t threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t bs = std::max<size_t>(1, config.blockSize);
+    size_t blocks = (n + bs - 1) / bs;
+
+    std::vector<Instrument> instruments;
+    std::vector<double> qty;
+    instruments.reserve(n);
+    qty.reserve(n);
+    for (const auto& p : book) {
+        instruments.push_back(p.instrument);
+        qty.push_back(p.quantity);
+    }
+
+    // The delta-gamma bumps difference base prices at 1e-8 scale, so they stay exact.
+    Precision basePrecision = config.deltaGamma ? Precision::Exact : config.precision;
+    std::vector<double> basePrice(n);
+    parallelFor(blocks, threads, [&](size_t b) {
+        size_t lo = b * bs, hi = std::min(n, lo + bs);
+        priceBatch(instruments.data() + lo, hi - lo, base, basePrice.data() + lo, basePrecision);
+    });
+    for (size_t i = 0; i < n; i++) report.basePv += qty[i] * basePrice[i];
+
+    report.pnl.assign(S, 0.0);
+    if (config.deltaGamma) {
+        // Dollar duration and half dollar convexity per position, from a 1bp
+        // parallel bump of the zero curve for every kind, so they are in the
+        // same (continuously compounded zero rate) units as the scenario moves.
+        const double h = 1e-4;
+        std::vector<double> up(n), down(n), dv(n), gm(n), mat(n);
+        YieldCurve curveUp = base.shifted(h), curveDown = base.shifted(-h);
+        parallelFor(blocks, threads, [&](size_t b) {
+            size_t lo = b * bs, hi = std::min(n, lo + bs);
+            priceBatch(instruments.data() + lo, hi - lo, curveUp, up.data() + lo);
+            priceBatch(instruments.data() + lo, hi - lo, curveDown, down.data() + lo);
+            for (size_t i = lo; i < hi; i++) {
+                double P = basePrice[i];
+                dv[i] = -(down[i] - up[i]) / (2 * h) * qty[i];
+                gm[i] = 0.5 * (up[i] + down[i] - 2 * P) / (h * h) * qty[i];
+                mat[i] = maturityOf(instruments[i]);
+            }
+        });
+        parallelFor(S, threads, [&](size_t s) {
+            double sum = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                double dy = history.moveAt(s, mat[i]);
+                sum += dv[i] * dy + gm[i] * dy * dy;
+            }
+            report.pnl[s] = sum;
+        });
+    } else {
+        std::vector<YieldCurve> curves;
+        curves.reserve(S);
+        std::vector<double> shift(base.tenors().size());
+        for (size_t s = 0; s < S; s++) {
+            for (size_t k = 0; k < shift.size(); k++) shift[k] = history.moveAt(s, base.tenors()[k]);
+            curves.push_back(base.shifted(shift));
+        }
+        // One work item per (scenario, position block); partial sums are
+        // reduced in block order so the result does not depend on scheduling.
+        std::vector<double> partial(S * blocks, 0.0);
+        parallelFor(S * blocks, threads, [&](size_t task) {
+            size_t s = task / blocks, b = task % blocks;
+            size_t lo = b * bs, hi = std::min(n, lo + bs);
+            thread_local std::vector<double> px;
+            px.resize(hi - lo);
+            priceBatch(instruments.data() + lo, hi - lo, curves[s], px.data(), config.precision);
+            double sum = 0.0;
+            for (size_t i = lo; i < hi; i++) sum += qty[i] * (px[i - lo] - basePrice[i]);
+            partial[task] = sum;
+        });
+        for (size_t s = 0; s < S; s++)
+            for (size_t b = 0; b < blocks; b++) report.pnl[s] += partial[s * blocks + b];
+    }
+
+    // Only the tail is ordered: the worst 'tail' losses are moved to the front.
+    size_t tail = std::max<size_t>(1, (size_t)std::ceil((1.0 - config.confidence) * S - 1e-9));
+    std::vector<double> losses(S);
+    for (size_t s = 0; s < S; s++) losses[s] = -report.pnl[s];
+    std::nth_element(losses.begin(), losses.begin() + (tail - 1), losses.end(), std::greater<double>());
+    report.var = losses[tail - 1];
+    double sum = 0.0;
+    for (size_t k = 0; k < tail; k++) sum += losses[k];
+    report.es = sum / tail;
+
+    report.success = true;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return report;
+}
+
+}
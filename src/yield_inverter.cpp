@@ -0,0 +1,73 @@
+#include "yield_inverter.h"
+#include <algorithm>
+
+namespace Bonds {
+
+YieldInverter::YieldInverter(const c_Bond& bond, double yMin, double yMax, int nodes)
+    : instrument(bond), pLo(bond.price_at(yMax)), pHi(bond.price_at(yMin)),
+      xLo(std::log(pLo)), xHi(std::log(pHi)) {
+    if (nodes < 2) nodes = 2;
+
+    // Sample y at Chebyshev nodes of the log-price interval with a full solve,
+    // then project onto the Chebyshev basis (discrete cosine transform).
+    // log P is close to linear in y (slope -duration), so the series converges fast.
+    std::vector<double> y(nodes);
+    double mid = 0.5*(xHi+xLo), half = 0.5*(xHi-xLo);
+    for (int k = 0; k < nodes; k++) {
+        double x = std::cos(M_PI*(k+0.5)/nodes);
+        y[k] = instrument.ytm(std::exp(mid + half*x), 100, 1e-14);
+    }
+    coeffs.assign(nodes, 0.0);
+    for (int j = 0; j < nodes; j++) {
+        double sum = 0.0;
+        for (int k = 0; k < nodes; k++) sum += y[k]*std::cos(M_PI*j*(k+0.5)/nodes);
+        coeffs[j] = 2.0*sum/nodes;
+    }
+    coeffs[0] *= 0.5;
+    // Drop the negligible tail so short instruments evaluate fewer terms.
+    while (coeffs.size() > 2 && std::abs(coeffs.back()) < 1e-16) coeffs.pop_back();
+
+    // Measure the fit on a grid four times denser than the nodes. When it is
+    // already far inside the 1e-10 target the Newton refinement is skipped.
+    fitError = 0.0;
+    for (int k = 0; k <= 4*nodes; k++) {
+        double p = std::exp(xLo + (xHi-xLo)*k/(4.0*nodes));
+        fitError = std::max(fitError, std::abs(guess(p) - instrument.ytm(p, 100, 1e-14)));
+    }
+}
+
+double YieldInverter::guess(double marketPrice) const {
+    // Clenshaw recurrence
+    double x = (2.0*std::log(marketPrice) - xHi - xLo)/(xHi - xLo);
+    double b1 = 0.0, b2 = 0.0;
+    for (size_t j = coeffs.size()-1; j > 0; j--) {
+        double b0 = 2.0*x*b1 - b2 + coeffs[j];
+        b2 = b1;
+        b1 = b0;
+    }
+    return x*b1 - b2 + coeffs[0];
+}
+
+double YieldInverter::ytm(double marketPrice) const {
+    if (!(marketPrice >= pLo && marketPrice <= pHi)) return instrument.ytm(marketPrice);
+
+    double y = guess(marketPrice);
+    if (fitError < 1e-12) return y;
+
+    // Newton converges quadratically from the fitted guess; a step under 1e-6
+    // leaves an error around 1e-12, so usually one or two steps suffice.
+    for (int i = 0; i < 4; i++) {
+        double dPdy;
+        double step = (instrument.price_at(y, &dPdy) - marketPrice)/dPdy;
+        y -= step;
+        if (std::abs(step) < 1e-6) break;
+    }
+    return y;
+}
+
+bool YieldInverter::matches(const c_Bond& other) const {
+    return other.face_value() == instrument.face_value() && other.coupon_rate() == instrument.coupon_rate() &&
+           other.maturity() == instrument.maturity() && other.frequency() == instrument.frequency();
+}
+
+}
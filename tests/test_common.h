@@ -0,0 +1,34 @@
+#ifndef BONDS_PRICER_TEST_COMMON_H
+#define BONDS_PRICER_TEST_COMMON_H
+
+#include <cmath>
+#include <iostream>
+
+// Minimal checks: failures are counted and reported, and main returns
+// TEST_RESULT() so ctest sees a non-zero exit.
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+            testFailures()++;                                                         \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                         \
+    do {                                                                              \
+        double va_ = (a), vb_ = (b);                                                  \
+        if (!(std::fabs(va_ - vb_) <= (tol))) {                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " #a " = " << va_          \
+                      << ", expected " << vb_ << " +/- " << (tol) << "\n";            \
+            testFailures()++;                                                         \
+        }                                                                             \
+    } while (0)
+
+#define TEST_RESULT() (testFailures() == 0 ? 0 : 1)
+
+#endif
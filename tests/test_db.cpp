@@ -0,0 +1,100 @@
+#include "db.h"
+#include "test_common.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+
+static void removeDb(const std::string& path) {
+    for (const char* suffix : {"", "-wal", "-shm"}) std::remove((path + suffix).c_str());
+}
+
+static std::string tempDb(const char* tag) {
+    std::string path = "/tmp/bond_pricer_" + std::string(tag) + "_" + std::to_string(getpid()) + ".db";
+    removeDb(path);
+    return path;
+}
+
+static bool contains(const std::vector<std::string>& v, const std::string& s) {
+    return std::find(v.begin(), v.end(), s) != v.end();
+}
+
+// Rows queued for the writer must still land when an index calls bond_price.
+static void writeBehindWithFunctionIndex() {
+    std::string path = tempDb("fn_index");
+    {
+        BondDB db(path);
+        db.init();
+        QueryResult idx = db.query("CREATE INDEX px ON bonds(bond_price(FV,c,r,T,freq));");
+        CHECK(idx.success);
+        db.enableWriteBehind();
+        db.saveBond("queued", "Coupon", 100, 0.05, 0.04, 5, 2, 104.49, "USD");
+        db.flush();
+        CHECK(contains(db.listBonds(), "queued"));
+    }
+    BondDB reopened(path);
+    reopened.init();
+    CHECK(contains(reopened.listBonds(), "queued"));
+    QueryResult px = reopened.query("SELECT bond_price(FV,c,r,T,freq) FROM bonds WHERE name='queued';");
+    CHECK(px.success && px.rows.size() == 1);
+    removeDb(path);
+}
+
+// A batch that fails to commit is kept and retried, and flush/saveBond say so.
+static void failedCommitIsRetried() {
+    std::string path = tempDb("retry");
+    BondDB db(path);
+    db.init();
+    CHECK(db.query("CREATE TABLE blocker(x);").success);
+    CHECK(db.query("CREATE TRIGGER block BEFORE INSERT ON bonds WHEN (SELECT count(*) FROM blocker) > 0 "
+                   "BEGIN SELECT RAISE(ABORT, 'blocked'); END;").success);
+    CHECK(db.query("INSERT INTO blocker VALUES(1);").success);
+
+    DBWriterConfig cfg;
+    cfg.flushIntervalMs = 1;
+    cfg.maxBackoffMs = 20;
+    db.enableWriteBehind(cfg);
+    CHECK(db.saveBond("first", "Coupon", 100, 0.05, 0.04, 5, 2, 104.49, "USD"));
+    CHECK(!db.flush());
+    CHECK(db.lastError().find("blocked") != std::string::npos);
+    CHECK(!db.saveBond("second", "Coupon", 100, 0.05, 0.04, 5, 2, 104.49, "USD"));
+    CHECK(!db.flush());
+    CHECK(db.listBonds().empty());
+
+    // Once the blocker goes the same rows commit, in order.
+    CHECK(db.query("DELETE FROM blocker;").success);
+    bool flushed = false;
+    for (int i = 0; i < 100 && !flushed; i++) flushed = db.flush();
+    CHECK(flushed);
+    std::vector<std::string> names = db.listBonds();
+    CHECK(names.size() == 2 && names[0] == "first" && names[1] == "second");
+    CHECK(db.saveBond("third", "Coupon", 100, 0.05, 0.04, 5, 2, 104.49, "USD"));
+    CHECK(db.flush());
+    removeDb(path);
+}
+
+// A batch still failing at shutdown is reported as dropped, not committed.
+static void shutdownReportsDroppedRows() {
+    std::string path = tempDb("drop");
+    BondDB db(path);
+    db.init();
+    CHECK(db.query("CREATE TRIGGER block BEFORE INSERT ON bonds BEGIN SELECT RAISE(ABORT, 'blocked'); END;").success);
+    DBWriterConfig cfg;
+    cfg.maxBackoffMs = 10;
+    BondDBWriter writer(path, cfg);
+    CHECK(writer.enqueue({"lost", "Coupon", 100, 0.05, 0.04, 5, 2, 104.49, "USD"}));
+    CHECK(!writer.flush());
+    CHECK(writer.failing());
+    writer.stop();
+    CHECK(writer.committed() == 0);
+    CHECK(writer.dropped() == 1);
+    CHECK(!writer.flush());
+    removeDb(path);
+}
+
+int main() {
+    writeBehindWithFunctionIndex();
+    failedCommitIsRetried();
+    shutdownReportsDroppedRows();
+    return TEST_RESULT();
+}
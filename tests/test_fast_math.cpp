@@ -0,0 +1,98 @@
+#include "fast_math.h"
+#include "bond.h"
+#include "instrument.h"
+#include "test_common.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Bonds;
+
+static void fastExpMatchesLibm() {
+    double worst = 0.0;
+    const int n = 2000000;
+    for (int i = 0; i <= n; i++) {
+        double x = -708.0 + 1416.0 * i / n;
+        worst = std::max(worst, std::fabs(fastExp(x) / std::exp(x) - 1.0));
+    }
+    for (double x : {0.0, 1e-300, -1e-300, 0.5 * std::log(2.0), -0.5 * std::log(2.0), 1.0, -1.0})
+        worst = std::max(worst, std::fabs(fastExp(x) / std::exp(x) - 1.0));
+    CHECK(worst < 1e-15);
+    // Clamped outside the domain.
+    CHECK(fastExp(-1000.0) == fastExp(-708.0));
+    CHECK(std::isfinite(fastExp(1000.0)));
+}
+
+static void fastLog1pMatchesLibm() {
+    double worst = 0.0;
+    const int n = 2000000;
+    for (int i = 1; i <= n; i++) {
+        double x = -0.5 + 100.5 * i / n;
+        worst = std::max(worst, std::fabs(fastLog1p(x) - std::log1p(x)));
+    }
+    // Small rates are where discounting lives; check them densely.
+    for (int i = -n / 2; i <= n / 2; i++) {
+        double x = 0.25 * i / n;
+        worst = std::max(worst, std::fabs(fastLog1p(x) - std::log1p(x)));
+    }
+    for (double x : {1e-300, 1e-17, -1e-17, -0.4999999, std::sqrt(2.0) - 1.0})
+        worst = std::max(worst, std::fabs(fastLog1p(x) - std::log1p(x)));
+    CHECK(worst < 1e-15);
+}
+
+static void bondFastWithinBound() {
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> rate(-0.02, 0.25), coupon(0.0, 0.12);
+    const int freqs[] = {1, 2, 4, 12};
+    std::vector<c_Bond> bonds;
+    for (int i = 0; i < 2000; i++) {
+        int freq = freqs[i % 4];
+        int T = 1 + (int)(rng() % (kFastMaxPeriods / freq));
+        bonds.emplace_back(100.0, coupon(rng), rate(rng), T, freq);
+    }
+    bonds.emplace_back(100.0, 0.05, 0.04, kFastMaxPeriods / 12, 12);
+    std::vector<double> exact, fast;
+    price_batch(bonds, exact);
+    price_batch(bonds, fast, Precision::Fast);
+    for (size_t i = 0; i < bonds.size(); i++) {
+        CHECK(fast[i] == bonds[i].price(Precision::Fast));
+        CHECK_NEAR(fast[i] / exact[i], 1.0, kFastPriceRelError);
+    }
+
+    // Outside the documented domain Fast falls back to Exact.
+    c_Bond longBond(100.0, 0.05, 0.04, 100, 12);
+    CHECK(longBond.price(Precision::Fast) == longBond.price());
+    c_Bond negative(100.0, 0.05, -1.2, 5, 2);
+    CHECK(negative.price(Precision::Fast) == negative.price());
+}
+
+static void instrumentsFastWithinBound() {
+    YieldCurve curve({0.25, 1, 2, 5, 10, 30}, {0.031, 0.034, 0.036, 0.039, 0.041, 0.043});
+    std::vector<Instrument> book;
+    const int freqs[] = {1, 2, 4, 12};
+    for (int i = 0; i < 400; i++) {
+        int freq = freqs[i % 4];
+        double T = 1 + i % 30;
+        switch (i % 4) {
+            case 0: book.push_back(FixedBullet{100.0, 0.05, T, freq}); break;
+            case 1: book.push_back(FloatingRateNote{100.0, 0.004, T, freq, {0.035}}); break;
+            case 2: book.push_back(Amortizer{100.0, 0.045, T, freq, std::vector<double>(size_t(T * freq / 2), 0.02)}); break;
+            default: book.push_back(StepUp{100.0, T, freq, {{0.0, 0.03}, {T / 2, 0.05}}}); break;
+        }
+    }
+    std::vector<double> exact, fast;
+    priceBatch(book, curve, exact);
+    priceBatch(book, curve, fast, Precision::Fast);
+    for (size_t i = 0; i < book.size(); i++) {
+        CHECK(fast[i] == price(book[i], curve, Precision::Fast));
+        CHECK_NEAR(fast[i] / exact[i], 1.0, kFastPriceRelError);
+    }
+}
+
+int main() {
+    fastExpMatchesLibm();
+    fastLog1pMatchesLibm();
+    bondFastWithinBound();
+    instrumentsFastWithinBound();
+    return TEST_RESULT();
+}
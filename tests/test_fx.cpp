@@ -0,0 +1,82 @@
+#include "fx.h"
+#include "test_common.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static void crossRatesAndTotal() {
+    FxService fx("USD", {{"EUR", 0.9}, {"JPY", 150.0}});
+    auto snap = fx.snapshot();
+    CHECK_NEAR(snap->rate("EUR", "JPY"), 150.0 / 0.9, 1e-9);
+    CHECK_NEAR(snap->rate("USD", "USD"), 1.0, 0.0);
+    CHECK(snap->index("CHF") < 0);
+
+    FxPositions pos;
+    pos.add(snap->index("USD"), 100.0);
+    pos.add(snap->index("EUR"), 90.0);
+    pos.add(snap->index("JPY"), 15000.0);
+    CHECK_NEAR(FxService::total(*snap, pos, snap->index("USD")), 300.0, 1e-9);
+    CHECK_NEAR(FxService::total(*snap, pos, snap->index("EUR")), 270.0, 1e-9);
+
+    // Indices survive updates; new currencies are appended.
+    int eur = snap->index("EUR");
+    fx.update({{"GBP", 0.8}, {"EUR", 0.95}, {"BAD", -1.0}});
+    auto next = fx.snapshot();
+    CHECK(next->version == snap->version + 1);
+    CHECK(next->index("EUR") == eur);
+    CHECK(next->index("BAD") < 0);
+    CHECK_NEAR(next->rate("EUR", "GBP"), 0.8 / 0.95, 1e-12);
+    CHECK_NEAR(snap->rate("USD", "EUR"), 0.9, 0.0);   // old snapshot untouched
+}
+
+// Readers total a book while a writer republishes. Every update moves all
+// quotes by the same factor k, so within one snapshot EUR->GBP is always 2
+// and a book of 1 EUR + 2 USD is worth 2 + 1/k USD for that snapshot's k.
+static void concurrentReadersSeeWholeSnapshots() {
+    FxService fx("USD", {{"EUR", 1.0}, {"GBP", 2.0}});
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++)
+        readers.emplace_back([&] {
+            uint64_t lastVersion = 0;
+            while (!done.load()) {
+                auto snap = fx.snapshot();
+                int usd = snap->index("USD"), eur = snap->index("EUR"), gbp = snap->index("GBP");
+                double k = snap->rate(usd, eur);
+                FxPositions pos;
+                pos.add(eur, 1.0);
+                pos.add(usd, 2.0);
+                if (std::fabs(snap->rate(eur, gbp) - 2.0) > 1e-12) bad++;
+                if (std::fabs(FxService::total(*snap, pos, usd) - (2.0 + 1.0 / k)) > 1e-12) bad++;
+                if (snap->version < lastVersion) bad++;
+                lastVersion = snap->version;
+            }
+        });
+    for (int i = 1; i <= 20000; i++) {
+        double k = 1.0 + (i % 97) * 0.01;
+        fx.update({{"EUR", k}, {"GBP", 2.0 * k}});
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+    CHECK(bad.load() == 0);
+    CHECK(fx.snapshot()->version == 20001);
+}
+
+// The constructor drops unusable rates the same way update() does.
+static void constructorSkipsBadRates() {
+    FxService fx("USD", {{"EUR", 0.9}, {"ZERO", 0.0}, {"NEG", -2.0}, {"NAN", NAN}, {"INF", INFINITY}, {"USD", 3.0}});
+    auto snap = fx.snapshot();
+    CHECK(snap->size() == 2);
+    for (const char* bad : {"ZERO", "NEG", "NAN", "INF"}) CHECK(snap->index(bad) < 0);
+    CHECK_NEAR(snap->rate("USD", "EUR"), 0.9, 0.0);
+    CHECK_NEAR(snap->rate("USD", "USD"), 1.0, 0.0);
+}
+
+int main() {
+    crossRatesAndTotal();
+    concurrentReadersSeeWholeSnapshots();
+    constructorSkipsBadRates();
+    return TEST_RESULT();
+}
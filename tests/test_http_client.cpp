@@ -0,0 +1,175 @@
+#include "http_client.h"
+#include "market_data.h"
+#include "test_common.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// In-process HTTP/1.1 stub on 127.0.0.1. Each connection serves requests
+// until the client closes it:
+//   /plain    Content-Length body
+//   /chunked  the same body in three chunks
+//   /busy     429 with a long Retry-After on every other request
+//   /query    an Alpha Vantage daily series
+class StubServer {
+public:
+    StubServer() {
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listenFd, (sockaddr*)&addr, sizeof(addr));
+        ::listen(listenFd, 16);
+        socklen_t len = sizeof(addr);
+        getsockname(listenFd, (sockaddr*)&addr, &len);
+        port = ntohs(addr.sin_port);
+        acceptor = std::thread([this] { acceptLoop(); });
+    }
+
+    ~StubServer() {
+        shutdown(listenFd, SHUT_RDWR);
+        acceptor.join();
+        close(listenFd);
+        for (auto& t : handlers) t.join();
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port); }
+
+    std::atomic<int> connections{0};
+    std::atomic<int> requests{0};
+
+private:
+    void acceptLoop() {
+        while (true) {
+            int fd = accept(listenFd, nullptr, nullptr);
+            if (fd < 0) return;
+            connections++;
+            std::lock_guard<std::mutex> lock(mtx);
+            handlers.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buf;
+        char chunk[4096];
+        while (true) {
+            size_t end;
+            while ((end = buf.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                buf.append(chunk, (size_t)n);
+            }
+            std::string head = buf.substr(0, end);
+            buf.erase(0, end + 4);
+            std::string path = head.substr(4, head.find(' ', 4) - 4);
+            int seq = requests++;
+            std::string reply = respond(path, seq);
+            send(fd, reply.data(), reply.size(), MSG_NOSIGNAL);
+        }
+    }
+
+    std::string respond(const std::string& path, int seq) {
+        if (path == "/plain") return "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+        if (path == "/chunked")
+            return "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                   "3\r\nhel\r\n1\r\nl\r\n1\r\no\r\n0\r\n\r\n";
+        if (path == "/busy" && seq % 2 == 0)
+            return "HTTP/1.1 429 Too Many Requests\r\nRetry-After: 3600\r\nContent-Length: 0\r\n\r\n";
+        if (path == "/busy") return "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+        if (path.rfind("/query", 0) == 0) {
+            std::string body = "{\"Time Series (Daily)\":{\"2024-01-02\":{\"1. open\":\"10\",\"2. high\":\"12\","
+                               "\"3. low\":\"9\",\"4. close\":\"11\",\"5. volume\":\"100\"}}}";
+            return "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+        }
+        return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+    }
+
+    int listenFd;
+    int port = 0;
+    std::thread acceptor;
+    std::mutex mtx;
+    std::vector<std::thread> handlers;
+};
+
+static HttpClientConfig stubConfig(const StubServer& stub) {
+    HttpClientConfig cfg;
+    cfg.baseUrl = stub.url();
+    cfg.maxConnections = 1;
+    cfg.requestsPerMinute = 0;
+    cfg.backoffMs = 1;
+    cfg.timeoutMs = 2000;
+    return cfg;
+}
+
+// Sequential requests share one keep-alive connection, whatever the framing.
+static void connectionIsReused() {
+    StubServer stub;
+    {
+        HttpClient client(stubConfig(stub));
+        for (int i = 0; i < 3; i++) {
+            HttpResponse plain = client.get("/plain");
+            HttpResponse chunked = client.get("/chunked");
+            CHECK(plain.success && plain.body == "hello");
+            CHECK(chunked.success && chunked.body == "hello");
+        }
+    }
+    CHECK(stub.connections == 1);
+    CHECK(stub.requests == 6);
+}
+
+// A 429 is retried, and the server's hour-long Retry-After is capped.
+static void tooManyRequestsIsRetried() {
+    StubServer stub;
+    {
+        HttpClientConfig cfg = stubConfig(stub);
+        cfg.maxBackoffMs = 20;
+        HttpClient client(cfg);
+        auto start = std::chrono::steady_clock::now();
+        HttpResponse resp = client.get("/busy");
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        CHECK(resp.success && resp.body == "ok");
+        CHECK(resp.attempts == 2);
+        CHECK(seconds < 2.0);
+
+        cfg.maxRetries = 0;
+        HttpClient noRetry(cfg);
+        HttpResponse failed = noRetry.get("/busy");
+        CHECK(!failed.success && failed.status == 429 && failed.attempts == 1);
+    }
+}
+
+// Reconfiguring while fetches are in flight swaps the client under them;
+// each fetch finishes on the snapshot it started with.
+static void configureDuringFetch() {
+    StubServer stub;
+    MarketData::setApiKey("demo");
+    MarketData::configure(stubConfig(stub));
+    std::atomic<bool> done{false};
+    std::thread reconfigure([&] {
+        while (!done) MarketData::configure(stubConfig(stub));
+    });
+    for (int i = 0; i < 20; i++) {
+        MarketDataResult r = MarketData::fetchStockData("ABC");
+        CHECK(r.success && r.error_message.empty());
+        CHECK(r.data["price"] == 11.0);
+    }
+    done = true;
+    reconfigure.join();
+    MarketData::configure(HttpClientConfig());
+}
+
+int main() {
+    connectionIsReused();
+    tooManyRequestsIsRetried();
+    configureDuringFetch();
+    return TEST_RESULT();
+}
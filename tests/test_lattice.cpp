@@ -0,0 +1,53 @@
+#include "lattice.h"
+#include "instrument.h"
+#include "test_common.h"
+
+using namespace Bonds;
+
+static const YieldCurve curve({0.5, 2, 5, 10, 30}, {0.030, 0.033, 0.036, 0.039, 0.041});
+
+// Coupon dates that land on tree steps are discounted exactly, so a bond
+// without options reprices to the curve, including a short first period.
+static void straightBondMatchesCurve() {
+    auto lat = HullWhiteLattice::build(curve, 0.05, 0.01, 10.0, 120);
+    for (double T : {5.0, 7.3, 4.25}) {
+        CallableBond b{100.0, 0.06, T, 2, {}, {}};
+        double expected = price(FixedBullet{100.0, 0.06, T, 2}, curve);
+        CHECK_NEAR(lat->price(b), expected, expected * 1e-10);
+    }
+}
+
+static void optionsBoundTheStraightBond() {
+    auto lat = HullWhiteLattice::build(curve, 0.05, 0.01, 10.0);
+    CallableBond straight{100.0, 0.05, 8.0, 2, {}, {}};
+    CallableBond callable = straight, putable = straight;
+    for (double t = 3.0; t < 8.0; t += 0.5) {
+        callable.calls.push_back({t, 100.0});
+        putable.puts.push_back({t, 100.0});
+    }
+    double s = lat->price(straight), c = lat->price(callable), p = lat->price(putable);
+    CHECK(c < s);
+    CHECK(s < p);
+}
+
+static void cacheEvictsLeastRecentlyUsed() {
+    LatticeCache cache(2);
+    YieldCurve a = YieldCurve::flat(0.03), b = YieldCurve::flat(0.04), c = YieldCurve::flat(0.05);
+    auto la = cache.get(a, 0.05, 0.01, 5.0);
+    CHECK(cache.get(a, 0.05, 0.01, 5.0) == la);
+    cache.get(b, 0.05, 0.01, 5.0);
+    cache.get(a, 0.05, 0.01, 5.0);      // a is now the most recent
+    cache.get(c, 0.05, 0.01, 5.0);      // evicts b
+    CHECK(cache.size() == 2);
+    CHECK(cache.get(a, 0.05, 0.01, 5.0) == la);
+    cache.clear();
+    CHECK(cache.size() == 0);
+    CHECK(cache.get(a, 0.05, 0.01, 5.0) != la);
+}
+
+int main() {
+    straightBondMatchesCurve();
+    optionsBoundTheStraightBond();
+    cacheEvictsLeastRecentlyUsed();
+    return TEST_RESULT();
+}
@@ -0,0 +1,75 @@
+#include "pricing_cache.h"
+#include "test_common.h"
+
+using namespace Bonds;
+
+static PricingKey key(int i) { return PricingKey::couponBond(1000.0, 0.05, 0.03 + i * 1e-4, 10, 2); }
+
+static bool cached(PricingCache& cache, const PricingKey& k) {
+    PricingResult r;
+    return cache.lookup(k, r);
+}
+
+// With one shard the whole cache is a single LRU list: a lookup refreshes an
+// entry, so the least recently used one goes first.
+static void evictsLeastRecentlyUsed() {
+    PricingCache cache(3, 1);
+    for (int i = 0; i < 3; i++) cache.insert(key(i), PricingCache::compute(key(i)));
+    CHECK(cached(cache, key(0)));           // order now 0, 2, 1
+    cache.insert(key(3), PricingCache::compute(key(3)));
+    CHECK(!cached(cache, key(1)));
+    CHECK(cached(cache, key(0)) && cached(cache, key(2)) && cached(cache, key(3)));
+
+    cache.insert(key(2), PricingCache::compute(key(2)));   // re-insert refreshes, no eviction
+    cache.insert(key(4), PricingCache::compute(key(4)));
+    CHECK(!cached(cache, key(0)));
+    CHECK(cached(cache, key(2)));
+    CHECK(cache.stats().evictions == 2);
+}
+
+// Capacity is split evenly (rounded up) across shards and each shard evicts
+// on its own, so the cache never holds more than shards * ceil(capacity / shards).
+static void capacityIsPerShard() {
+    PricingCache cache(10, 4);      // 3 per shard
+    for (int i = 0; i < 500; i++) cache.get(key(i));
+    PricingCache::Stats st = cache.stats();
+    CHECK(st.size <= 12);
+    CHECK(st.size >= 4);
+    CHECK(st.evictions == 500 - st.size);
+
+    PricingCache tiny(0, 0);        // clamps to one shard of one entry
+    tiny.get(key(0));
+    tiny.get(key(1));
+    CHECK(tiny.stats().size == 1);
+    CHECK(!cached(tiny, key(0)) && cached(tiny, key(1)));
+}
+
+static void countersTrackHitsAndMisses() {
+    PricingCache cache(16, 2);
+    PricingResult first = cache.get(PricingKey::zeroCoupon(1000.0, 0.0, 5));
+    PricingResult again = cache.get(PricingKey::zeroCoupon(1000.0, -0.0, 5));   // same key after folding -0.0
+    PricingResult exact = PricingCache::compute(PricingKey::zeroCoupon(1000.0, 0.0, 5));
+    CHECK(first.price == exact.price && again.price == exact.price);
+    cache.get(key(1));
+    cache.get(key(1));
+    cache.get(key(1));
+
+    PricingCache::Stats st = cache.stats();
+    CHECK(st.hits == 3 && st.misses == 2 && st.evictions == 0);
+    CHECK(st.size == 2);
+    CHECK_NEAR(st.hitRate(), 0.6, 1e-12);
+
+    cache.clear();
+    st = cache.stats();
+    CHECK(st.size == 0 && st.hits == 3);
+    CHECK(!cached(cache, key(1)));
+    CHECK(cache.stats().misses == 3);
+    CHECK(PricingCache(4).stats().hitRate() == 0.0);
+}
+
+int main() {
+    evictsLeastRecentlyUsed();
+    capacityIsPerShard();
+    countersTrackHitsAndMisses();
+    return TEST_RESULT();
+}
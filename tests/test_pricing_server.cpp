@@ -0,0 +1,176 @@
+#include "pricing_server.h"
+#include "test_common.h"
+#include <cstring>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static std::string socketPath(const char* tag) {
+    return "/tmp/bond_pricer_" + std::string(tag) + "_" + std::to_string(getpid()) + ".sock";
+}
+
+static int connectTo(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void sendAll(int fd, const std::string& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = send(fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        off += (size_t)n;
+    }
+}
+
+// Reads one reply line; empty once the server has closed the connection.
+static std::string readLine(int fd) {
+    std::string line;
+    char ch;
+    while (recv(fd, &ch, 1, 0) == 1) {
+        if (ch == '\n') return line;
+        line += ch;
+    }
+    return line;
+}
+
+// Client-supplied symbols are echoed back as sent.
+static void symbolsAreEchoed() {
+    PricingServer server(ServerConfig{});
+    PricingRequest req;
+    CHECK(PricingServer::parseRequest("{\"id\":3,\"symbol\":\"CLIENT \\\"A\\\"\",\"FV\":100,\"c\":0.05,\"r\":0.04,\"T\":5,\"freq\":2}", req));
+    CHECK(req.symbol == "CLIENT \"A\"");
+    CHECK(server.evaluate(req).find("\"symbol\":\"CLIENT \\\"A\\\"\"") != std::string::npos);
+}
+
+// The socket is open once listen() returns, before run() is called.
+static void listenBeforeRun() {
+    ServerConfig cfg;
+    cfg.unixPath = socketPath("listen");
+    PricingServer server(cfg);
+    CHECK(server.listen());
+    int fd = connectTo(cfg.unixPath);
+    CHECK(fd >= 0);
+    std::thread serving([&] { CHECK(server.run()); });
+    sendAll(fd, "{\"id\":7,\"FV\":100,\"c\":0.05,\"r\":0.05,\"T\":5,\"freq\":2}\n");
+    std::string reply = readLine(fd);
+    CHECK(reply.find("\"id\":7") != std::string::npos && reply.find("\"ok\":true") != std::string::npos);
+    server.stop();
+    serving.join();
+    close(fd);
+    CHECK(connectTo(cfg.unixPath) < 0);
+
+    ServerConfig bad;
+    bad.host = "not-an-address";
+    PricingServer failing(bad);
+    CHECK(!failing.listen());
+    CHECK(failing.error().find("invalid listen address") != std::string::npos);
+    CHECK(!failing.run());
+}
+
+// stop() may come before run(), or race the accept loop from other threads.
+static void stopFromAnyThread() {
+    ServerConfig cfg;
+    cfg.unixPath = socketPath("stop");
+    {
+        PricingServer server(cfg);
+        server.stop();
+        CHECK(server.run());
+    }
+    for (int i = 0; i < 20; i++) {
+        PricingServer server(cfg);
+        CHECK(server.listen());
+        std::thread serving([&] { server.run(); });
+        std::thread a([&] { server.stop(); }), b([&] { server.stop(); });
+        a.join();
+        b.join();
+        serving.join();
+        server.stop();
+    }
+}
+
+// An unterminated line past maxLineBytes gets an error reply and the client is dropped.
+static void overlongLinesDropTheClient() {
+    ServerConfig cfg;
+    cfg.unixPath = socketPath("maxline");
+    cfg.maxLineBytes = 1024;
+    PricingServer server(cfg);
+    CHECK(server.listen());
+    std::thread serving([&] { server.run(); });
+
+    int fd = connectTo(cfg.unixPath);
+    sendAll(fd, "{\"id\":1,\"FV\":100,\"c\":0.05,\"r\":0.05,\"T\":5,\"freq\":2}\n");
+    CHECK(readLine(fd).find("\"ok\":true") != std::string::npos);
+    sendAll(fd, std::string(4096, 'x'));
+    CHECK(readLine(fd).find("longer than 1024 bytes") != std::string::npos);
+    CHECK(readLine(fd).empty());
+    close(fd);
+
+    // Other clients are unaffected.
+    int other = connectTo(cfg.unixPath);
+    sendAll(other, "{\"id\":2,\"op\":\"stats\"}\n");
+    CHECK(readLine(other).find("\"id\":2") != std::string::npos);
+    close(other);
+
+    server.stop();
+    serving.join();
+}
+
+// Mistyped fields and oversized terms get an ok:false reply; the reader
+// thread survives and the same connection keeps being served.
+static void malformedRequestsAreRejected() {
+    const char* bad[] = {
+        "{\"id\":\"x\",\"FV\":100,\"c\":0.05,\"r\":0.05,\"T\":5,\"freq\":2}",
+        "{\"id\":1,\"FV\":\"x\",\"c\":0.05,\"r\":0.05,\"T\":5,\"freq\":2}",
+        "{\"id\":1,\"symbol\":{},\"FV\":100,\"c\":0.05,\"r\":0.05,\"T\":5,\"freq\":2}",
+        "{\"id\":1,\"FV\":100,\"c\":0.05,\"r\":0.05,\"T\":1e12,\"freq\":2}",
+        "{\"id\":1,\"FV\":100,\"c\":0.05,\"r\":0.05,\"T\":2000,\"freq\":12}",
+        "{\"id\":1,\"op\":7}",
+        "{\"id\":1,\"FV\":1e999,\"c\":0.05,\"r\":0.05,\"T\":5,\"freq\":2}",
+    };
+    for (const char* line : bad) {
+        PricingRequest req;
+        CHECK(!PricingServer::parseRequest(line, req));
+        CHECK(!req.error.empty());
+    }
+    std::string deep(5000, '[');
+    PricingRequest req;
+    CHECK(!PricingServer::parseRequest(deep, req));
+
+    ServerConfig cfg;
+    cfg.unixPath = socketPath("malformed");
+    PricingServer server(cfg);
+    CHECK(server.listen());
+    std::thread serving([&] { server.run(); });
+    int fd = connectTo(cfg.unixPath);
+    for (const char* line : bad) {
+        sendAll(fd, std::string(line) + "\n");
+        CHECK(readLine(fd).find("\"ok\":false") != std::string::npos);
+    }
+    sendAll(fd, deep + "\n");
+    CHECK(readLine(fd).find("invalid JSON") != std::string::npos);
+    sendAll(fd, "{\"id\":9,\"FV\":100,\"c\":0.05,\"r\":0.05,\"T\":5,\"freq\":2}\n");
+    std::string reply = readLine(fd);
+    CHECK(reply.find("\"id\":9") != std::string::npos && reply.find("\"ok\":true") != std::string::npos);
+    close(fd);
+    server.stop();
+    serving.join();
+}
+
+int main() {
+    malformedRequestsAreRejected();
+    symbolsAreEchoed();
+    listenBeforeRun();
+    stopFromAnyThread();
+    overlongLinesDropTheClient();
+    return TEST_RESULT();
+}
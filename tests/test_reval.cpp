@@ -0,0 +1,105 @@
+#include "reval_coordinator.h"
+#include "pricing_server.h"
+#include "test_common.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Spawned workers re-run this binary with --serve; the first one to claim
+// this file dies on its first connection, as if killed mid-shard.
+static std::string crashMarker(pid_t parent) {
+    return "/tmp/bond_pricer_reval_crash_" + std::to_string(parent);
+}
+
+static int serve(const std::string& path) {
+    if (unlink(crashMarker(getppid()).c_str()) == 0) {
+        unlink(path.c_str());
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(fd, 4) != 0) return 1;
+        int client = accept(fd, nullptr, nullptr);
+        char buf[256];
+        recv(client, buf, sizeof(buf), 0);
+        _exit(1);
+    }
+    ServerConfig cfg;
+    cfg.unixPath = path;
+    PricingServer server(cfg);
+    return server.run() ? 0 : 1;
+}
+
+static std::vector<RevalPosition> book() {
+    std::vector<RevalPosition> out;
+    for (int i = 0; i < 200; i++)
+        out.push_back({"BOND" + std::to_string(i), i % 3 != 0, 1000.0, 0.04 + i * 1e-4, 0.035, 1 + i % 30, 2, 1.0 + i % 5});
+    return out;
+}
+
+// Killing one of two local workers restarts it and resends its shard; the
+// merged totals match an undisturbed run exactly.
+static void killedWorkerIsRestarted() {
+    RevalConfig cfg;
+    cfg.spawn = 2;
+    RevalReport clean = RevalCoordinator(cfg).run(book());
+    CHECK(clean.success);
+    CHECK(clean.total.count == 200 && clean.total.errors == 0);
+
+    std::ofstream(crashMarker(getpid())) << "x";
+    RevalReport rerun = RevalCoordinator(cfg).run(book());
+    CHECK(rerun.success);
+    CHECK(rerun.total.attempts == 3);
+    CHECK(rerun.total.count == clean.total.count);
+    CHECK(rerun.total.pv == clean.total.pv);
+    CHECK(rerun.total.dv01 == clean.total.dv01);
+
+    cfg.maxRestarts = 0;
+    std::ofstream(crashMarker(getpid())) << "x";
+    RevalReport failed = RevalCoordinator(cfg).run(book());
+    CHECK(!failed.success);
+    CHECK(failed.error_message.find("no totals") != std::string::npos);
+}
+
+// Non-finite rows are skipped on load and counted; run() rejects any it is handed.
+static void nonFinitePositionsAreSkipped() {
+    std::string path = "/tmp/bond_pricer_reval_" + std::to_string(getpid()) + ".csv";
+    std::ofstream(path) << "name,type,FV,c,r,T,freq,quantity\n"
+                        << "A,coupon,1000,0.05,0.04,5,2,1\n"
+                        << "B,coupon,nan,0.05,0.04,5,2,1\n"
+                        << "C,zc,1000,0,0.04,5,1,inf\n"
+                        << "D,coupon\n";
+    std::vector<RevalPosition> positions;
+    std::string error;
+    size_t skipped = 0;
+    CHECK(RevalCoordinator::loadSnapshot(path, positions, error, &skipped));
+    CHECK(positions.size() == 1 && positions[0].name == "A");
+    CHECK(skipped == 3);
+    unlink(path.c_str());
+
+    BondRecord bad{};
+    bad.name = "E";
+    bad.type = "Coupon";
+    bad.FV = 1000.0;
+    bad.r = NAN;
+    CHECK(RevalCoordinator::fromRecords({bad}, &skipped).empty());
+    CHECK(skipped == 1);
+
+    RevalConfig cfg;
+    cfg.spawn = 1;
+    positions.push_back({"F", true, 1000.0, 0.05, INFINITY, 5, 2, 1.0});
+    RevalReport rep = RevalCoordinator(cfg).run(positions);
+    CHECK(rep.success);
+    CHECK(rep.total.count == 1 && rep.total.errors == 1);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::string(argv[1]) == "--serve") return serve(argv[2]);
+    killedWorkerIsRestarted();
+    nonFinitePositionsAreSkipped();
+    return TEST_RESULT();
+}
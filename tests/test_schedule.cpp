@@ -0,0 +1,161 @@
+#include "schedule.h"
+#include "test_common.h"
+#include <cmath>
+
+using namespace Bonds;
+
+static ScheduleSpec spec(Date issue, Date maturity, StubType stub, DayCount dc = DayCount::ACT_ACT) {
+    ScheduleSpec s;
+    s.issue = issue;
+    s.maturity = maturity;
+    s.coupon = 0.06;
+    s.freq = 2;
+    s.dayCount = dc;
+    s.convention = BusinessDayConvention::Unadjusted;
+    s.stub = stub;
+    return s;
+}
+
+// Dirty price of 100 face paying 3 per regular period, with one stub of
+// 'stub' regular periods first (front) or last (back), at a 6% yield.
+static double expectedPrice(double w, double stub, int regular, bool front) {
+    double v = 1.0 / 1.03, pv = 0.0, t = 0.0;
+    int n = regular + 1;
+    for (int i = 0; i < n; i++) {
+        bool isStub = front ? i == 0 : i == n - 1;
+        double len = isStub ? stub : 1.0;
+        t += i == 0 ? w : len;
+        pv += (3.0 * len + (i == n - 1 ? 100.0 : 0.0)) * std::pow(v, t);
+    }
+    return pv;
+}
+
+static void shortFrontStub() {
+    auto s = Schedule::generate(spec(Date(2024, 1, 15), Date(2026, 3, 15), StubType::ShortFront));
+    CHECK(s->size() == 5);
+    double stub = 60.0 / 182.0;     // 2024-01-15..03-15 in the 2023-09-15..2024-03-15 period
+    CHECK_NEAR(s->periodLength[0], stub, 1e-12);
+    CHECK_NEAR(s->accrualFactor[0], stub / 2, 1e-12);
+
+    DatedPrice p = priceDated(*s, Date(2024, 1, 15), 0.06);
+    CHECK_NEAR(p.accrued, 0.0, 1e-12);
+    CHECK_NEAR(p.dirty, expectedPrice(stub, stub, 4, true), 1e-9);
+    CHECK_NEAR(p.dirty, 100.01, 0.005);
+
+    // 30 days in: ICMA accrues 30 of the notional 182-day period.
+    p = priceDated(*s, Date(2024, 2, 14), 0.06);
+    CHECK_NEAR(p.accrued, 3.0 * 30.0 / 182.0, 1e-12);
+    CHECK_NEAR(p.dirty, expectedPrice(30.0 / 182.0, stub, 4, true), 1e-9);
+}
+
+static void longFrontStub() {
+    auto s = Schedule::generate(spec(Date(2023, 11, 15), Date(2026, 3, 15), StubType::LongFront));
+    CHECK(s->size() == 4);
+    CHECK(s->accrualEnd[0] == Date(2024, 9, 15).days());
+    double stub = 1.0 + 121.0 / 182.0;  // one regular period plus 2023-11-15..2024-03-15
+    CHECK_NEAR(s->periodLength[0], stub, 1e-12);
+
+    DatedPrice p = priceDated(*s, Date(2023, 11, 15), 0.06);
+    CHECK_NEAR(p.dirty, expectedPrice(stub, stub, 3, true), 1e-9);
+    CHECK_NEAR(p.dirty, 100.0, 0.1);
+
+    // Inside the first notional period only part of the remainder has run;
+    // after 2024-03-15 the stub behaves like a regular period.
+    p = priceDated(*s, Date(2024, 1, 15), 0.06);
+    CHECK_NEAR(p.accrued, 3.0 * 61.0 / 182.0, 1e-12);
+    CHECK_NEAR(p.dirty, expectedPrice(stub - 61.0 / 182.0, stub, 3, true), 1e-9);
+    p = priceDated(*s, Date(2024, 6, 15), 0.06);
+    CHECK_NEAR(p.accrued, 3.0 * (121.0 / 182.0 + 92.0 / 184.0), 1e-12);
+}
+
+static void shortBackStub() {
+    auto s = Schedule::generate(spec(Date(2024, 3, 15), Date(2026, 5, 15), StubType::ShortBack));
+    CHECK(s->size() == 5);
+    double stub = 61.0 / 184.0;     // 2026-03-15..05-15 in the 2026-03-15..09-15 period
+    CHECK_NEAR(s->periodLength.back(), stub, 1e-12);
+
+    DatedPrice p = priceDated(*s, Date(2024, 3, 15), 0.06);
+    CHECK_NEAR(p.dirty, expectedPrice(1.0, stub, 4, false), 1e-9);
+    CHECK_NEAR(p.dirty, 100.0, 0.01);
+
+    p = priceDated(*s, Date(2026, 4, 15), 0.06);
+    CHECK_NEAR(p.accrued, 3.0 * 31.0 / 184.0, 1e-12);
+    CHECK_NEAR(p.dirty, (100.0 + 3.0 * stub) * std::pow(1.03, -30.0 / 184.0), 1e-9);
+}
+
+static void longBackStub() {
+    auto s = Schedule::generate(spec(Date(2024, 3, 15), Date(2026, 5, 15), StubType::LongBack));
+    CHECK(s->size() == 4);
+    CHECK(s->accrualStart.back() == Date(2025, 9, 15).days());
+    double stub = 1.0 + 61.0 / 184.0;
+    CHECK_NEAR(s->periodLength.back(), stub, 1e-12);
+
+    DatedPrice p = priceDated(*s, Date(2024, 3, 15), 0.06);
+    CHECK_NEAR(p.dirty, expectedPrice(1.0, stub, 3, false), 1e-9);
+    CHECK_NEAR(p.dirty, 100.0, 0.1);
+}
+
+static void accruedConventions() {
+    // Regular semiannual periods; settle 86 actual / 85 30-360 days after 2024-01-15.
+    Date issue(2024, 1, 15), maturity(2026, 1, 15), settle(2024, 4, 10);
+    auto act = Schedule::generate(spec(issue, maturity, StubType::ShortFront, DayCount::ACT_ACT));
+    auto thirty = Schedule::generate(spec(issue, maturity, StubType::ShortFront, DayCount::THIRTY_360));
+    auto act360 = Schedule::generate(spec(issue, maturity, StubType::ShortFront, DayCount::ACT_360));
+    CHECK_NEAR(accruedInterest(*act, settle), 3.0 * 86.0 / 182.0, 1e-12);
+    CHECK_NEAR(accruedInterest(*thirty, settle), 6.0 * 85.0 / 360.0, 1e-12);
+    CHECK_NEAR(accruedInterest(*act360, settle), 6.0 * 86.0 / 360.0, 1e-12);
+    CHECK_NEAR(act360->accrualFactor[0], 182.0 / 360.0, 1e-12);
+
+    // Nothing accrues on a coupon date; the full coupon is in the dirty price.
+    CHECK_NEAR(accruedInterest(*act, Date(2024, 7, 15)), 0.0, 1e-12);
+    DatedPrice p = priceDated(*act, Date(2024, 7, 15), 0.06);
+    CHECK_NEAR(p.dirty, 100.0, 1e-9);
+}
+
+// Each remaining cashflow is discounted at its payment date's ACT/365F time;
+// accrued interest is the same as the yield overload's.
+static void curvePricing() {
+    auto sched = Schedule::generate(spec(Date(2024, 1, 15), Date(2027, 3, 15), StubType::ShortFront));
+    YieldCurve curve({0.5, 1, 2, 5}, {0.030, 0.032, 0.035, 0.038});
+    Date settle(2024, 8, 2);
+    double expected = 0.0;
+    for (size_t i = 0; i < sched->size(); i++) {
+        if (sched->payDate[i] <= settle.days()) continue;
+        double t = (sched->payDate[i] - settle.days()) / 365.0;
+        expected += sched->amount[i] * std::exp(-curve.zero(t) * t);
+    }
+    DatedPrice p = priceDated(*sched, settle, curve);
+    CHECK_NEAR(p.dirty, expected, 1e-12);
+    CHECK_NEAR(p.accrued, accruedInterest(*sched, settle), 1e-15);
+    CHECK_NEAR(p.accrued, priceDated(*sched, settle, 0.05).accrued, 1e-15);
+    CHECK_NEAR(p.clean, p.dirty - p.accrued, 1e-12);
+
+    // A flat curve at the continuous equivalent of the yield lands close to the street price.
+    DatedPrice street = priceDated(*sched, settle, 0.06);
+    DatedPrice flat = priceDated(*sched, settle, YieldCurve::flat(2.0 * std::log(1.03)));
+    CHECK_NEAR(flat.dirty, street.dirty, 0.05);
+
+    DatedPrice matured = priceDated(*sched, Date(2027, 3, 16), curve);
+    CHECK(matured.dirty == 0.0 && matured.accrued == 0.0);
+}
+
+static void cacheSharesSchedules() {
+    ScheduleCache cache;
+    auto a = cache.get(spec(Date(2024, 1, 15), Date(2026, 3, 15), StubType::ShortFront));
+    auto b = cache.get(spec(Date(2024, 1, 15), Date(2026, 3, 15), StubType::ShortFront));
+    auto c = cache.get(spec(Date(2024, 1, 15), Date(2026, 3, 15), StubType::LongFront));
+    CHECK(a == b);
+    CHECK(a != c);
+    CHECK(cache.size() == 2);
+}
+
+int main() {
+    shortFrontStub();
+    longFrontStub();
+    shortBackStub();
+    longBackStub();
+    accruedConventions();
+    curvePricing();
+    cacheSharesSchedules();
+    return TEST_RESULT();
+}
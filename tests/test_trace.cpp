@@ -0,0 +1,42 @@
+#include "trace.h"
+#include "test_common.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+static std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static void scopesRecordOnlyWhileEnabled() {
+    CHECK(!Trace::isEnabled());
+    {
+        std::string arg = "before";
+        TRACE_SCOPE_ARG("off_scope", "test", "arg", arg);
+    }
+    Trace::start();
+    CHECK(Trace::isEnabled());
+    {
+        std::string arg;
+        if (Trace::isEnabled()) arg = std::to_string(42);
+        TRACE_SCOPE_ARG("on_scope", "test", "rows", arg);
+    }
+    std::string path = "/tmp/bond_pricer_trace_" + std::to_string(getpid()) + ".json";
+    CHECK(Trace::dump(path));
+    CHECK(!Trace::isEnabled());
+    std::string json = readFile(path);
+    CHECK(json.find("\"on_scope\"") != std::string::npos);
+    CHECK(json.find("\"rows\":\"42\"") != std::string::npos);
+    CHECK(json.find("off_scope") == std::string::npos);
+    std::remove(path.c_str());
+}
+
+int main() {
+    scopesRecordOnlyWhileEnabled();
+    return TEST_RESULT();
+}
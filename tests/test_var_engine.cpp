@@ -0,0 +1,55 @@
+#include "var_engine.h"
+#include "bond.h"
+#include "test_common.h"
+#include <cmath>
+
+using namespace Bonds;
+
+static CurveHistory parallelMoves(std::vector<double> moves) {
+    CurveHistory h;
+    h.tenors = {1.0, 30.0};
+    for (double m : moves) h.moves.push_back({m, m});
+    h.success = true;
+    return h;
+}
+
+// A single-step StepUp has the same cashflows as a FixedBullet, so every kind
+// must get the same delta-gamma P&L; both track full revaluation closely.
+static void deltaGammaConsistentAcrossKinds() {
+    YieldCurve curve({0.5, 2, 5, 10, 30}, {0.030, 0.033, 0.036, 0.039, 0.041});
+    CurveHistory history = parallelMoves({-0.004, -0.001, 0.0005, 0.002, 0.005});
+    std::vector<Position> bullet{{FixedBullet{100.0, 0.05, 10.0, 2}, 10.0}};
+    std::vector<Position> step{{StepUp{100.0, 10.0, 2, {{0.0, 0.05}}}, 10.0}};
+
+    VarConfig dg;
+    dg.deltaGamma = true;
+    dg.confidence = 0.8;
+    VarReport a = runHistoricalVar(bullet, curve, history, dg);
+    VarReport b = runHistoricalVar(step, curve, history, dg);
+    VarReport full = runHistoricalVar(bullet, curve, history, VarConfig{0.8});
+    CHECK(a.success && b.success && full.success);
+    for (size_t s = 0; s < history.moves.size(); s++) {
+        CHECK_NEAR(a.pnl[s], b.pnl[s], 1e-9);
+        CHECK_NEAR(a.pnl[s], full.pnl[s], std::fabs(full.pnl[s]) * 0.01 + 1e-9);
+    }
+    CHECK(a.pnl[0] > 0 && a.pnl[4] < 0);
+    CHECK_NEAR(a.var, -a.pnl[4], 1e-12);
+}
+
+// Closed-form convexity matches a yield bump of the price.
+static void bondConvexityMatchesBump() {
+    const double h = 1e-4;
+    c_Bond b(100.0, 0.05, 0.04, 10, 2), up(100.0, 0.05, 0.04 + h, 10, 2), down(100.0, 0.05, 0.04 - h, 10, 2);
+    double P = b.price();
+    CHECK_NEAR(b.convexity(), (up.price() + down.price() - 2 * P) / (h * h * P), 1e-3);
+    CHECK_NEAR(b.modified_duration(), (down.price() - up.price()) / (2 * h * P), 1e-5);
+    zc_Bond z(100.0, 0.04, 10), zu(100.0, 0.04 + h, 10), zd(100.0, 0.04 - h, 10);
+    double Z = z.price();
+    CHECK_NEAR(z.convexity(), (zu.price() + zd.price() - 2 * Z) / (h * h * Z), 1e-3);
+}
+
+int main() {
+    deltaGammaConsistentAcrossKinds();
+    bondConvexityMatchesBump();
+    return TEST_RESULT();
+}
@@ -0,0 +1,45 @@
+#include "yield_inverter.h"
+#include "test_common.h"
+#include <cmath>
+
+using namespace Bonds;
+
+static const c_Bond bonds[] = {
+    c_Bond(1000.0, 0.05, 0.04, 10, 2),
+    c_Bond(100.0, 0.02, 0.03, 2, 1),
+    c_Bond(1000.0, 0.08, 0.06, 30, 12),
+    c_Bond(100.0, 0.0, 0.05, 5, 4),
+};
+
+// Inverting the bond's own price recovers the yield across the fitted band.
+static void roundTripsAcrossTheBand() {
+    for (const c_Bond& b : bonds) {
+        YieldInverter inv(b);
+        CHECK(inv.matches(b));
+        double worst = 0.0;
+        for (int k = 0; k <= 200; k++) {
+            double y = 0.20 * k / 200.0;
+            worst = std::max(worst, std::fabs(inv.ytm(b.price_at(y)) - y));
+        }
+        CHECK(worst < 1e-10);
+    }
+}
+
+// Prices outside [price at yMax, price at yMin] take the exact solver.
+static void outOfBandFallsBack() {
+    for (const c_Bond& b : bonds) {
+        YieldInverter inv(b, 0.01, 0.10);
+        for (double y : {-0.005, 0.0, 0.15, 0.30}) {
+            double p = b.price_at(y);
+            CHECK(inv.ytm(p) == b.ytm(p));
+            CHECK_NEAR(inv.ytm(p), y, 1e-5);
+        }
+    }
+    CHECK(!YieldInverter(bonds[0]).matches(bonds[1]));
+}
+
+int main() {
+    roundTripsAcrossTheBand();
+    outOfBandFallsBack();
+    return TEST_RESULT();
+}